@@ -0,0 +1,132 @@
+/*
+ * This file is protected by Copyright. Please refer to the COPYRIGHT file distributed with this
+ * source distribution.
+ *
+ * This file is part of REDHAWK Basic Components TuneFilterDecimate.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this
+ * program.  If not, see http://www.gnu.org/licenses/.
+ */
+#include "BandpassDecimator.h"
+
+#include <algorithm>
+#include <cmath>
+
+BandpassDecimator::BandpassDecimator(const RealVector& taps, size_t decimation, double tuningNorm, size_t blockSize) :
+	prototype(taps),
+	decimation(std::max(decimation, size_t(1))),
+	nextOutput(0),
+	tuningNorm(tuningNorm),
+	phase(0),
+	step(Mixer::toFixed(tuningNorm)),
+	complexHistory(true),
+	realDot(taps),
+	imagDot(taps),
+	pairDot(taps)
+{
+	if (prototype.empty())
+		prototype.assign(1, 1.0f);
+	shiftTaps();
+
+	// The history is slid to the front of the working buffer once per block,
+	// so keep blocks at least as long as the history
+	this->blockSize = std::max(blockSize, prototype.size());
+	work.assign(prototype.size()-1 + this->blockSize, Complex(0,0));
+	realBlock.resize(this->blockSize);
+}
+
+void BandpassDecimator::shiftTaps()
+{
+	RealVector realTaps(prototype.size());
+	RealVector imagTaps(prototype.size());
+	ComplexVector shifted(prototype.size());
+	for (size_t k=0; k < prototype.size(); k++) {
+		double arg = 2.0*M_PI*fmod(tuningNorm*k, 1.0);
+		shifted[k] = Complex(prototype[k]*cos(arg), prototype[k]*sin(arg));
+		realTaps[k] = shifted[k].real();
+		imagTaps[k] = shifted[k].imag();
+	}
+	realDot = FirDotProduct(realTaps);
+	imagDot = FirDotProduct(imagTaps);
+	pairDot = FirDotProduct(shifted);
+}
+
+void BandpassDecimator::retune(double tuningNorm)
+{
+	if (tuningNorm == this->tuningNorm)
+		return;
+	this->tuningNorm = tuningNorm;
+	step = Mixer::toFixed(tuningNorm);
+	shiftTaps();
+}
+
+void BandpassDecimator::reset()
+{
+	std::fill(work.begin(), work.end(), Complex(0,0));
+	nextOutput = 0;
+	phase = 0;
+}
+
+double BandpassDecimator::getPhase() const
+{
+	return ldexp(double(phase), -64);
+}
+
+void BandpassDecimator::setPhase(double cycles)
+{
+	phase = Mixer::toFixed(cycles);
+}
+
+void BandpassDecimator::run(const InputSamples& input, ComplexVector& output)
+{
+	const size_t histLen = prototype.size()-1;
+	if (input.complexInput != complexHistory) {
+		// The history is kept in the form of the input, so a switch between real and complex starts it over
+		std::fill(work.begin(), work.begin()+histLen, Complex(0,0));
+		complexHistory = input.complexInput;
+	}
+
+	const size_t numSamples = input.numSamples;
+	output.reserve(output.size() + (numSamples + decimation - 1)/decimation + 1);
+	for (size_t done = 0; done < numSamples; ) {
+		const size_t blockLen = std::min(blockSize, numSamples - done);
+		const InputSamples block = input.slice(done, blockLen);
+		if (complexHistory) {
+			block.toComplex(&work[histLen]);
+		} else {
+			block.toFloat(&realBlock[0]);
+			for (size_t i=0; i < blockLen; i++)
+				work[histLen+i] = Complex(realBlock[i], realBlock[i]);
+		}
+
+		// The window of the output at block index n is work[n .. n+histLen]; the tuner
+		// would have mixed that sample down by exp(-j*2*pi*(phase + step*n))
+		size_t n = nextOutput;
+		for (; n < blockLen; n += decimation) {
+			Complex filtered;
+			if (complexHistory) {
+				const Complex re = realDot(&work[n]);
+				const Complex im = imagDot(&work[n]);
+				filtered = Complex(re.real() - im.imag(), re.imag() + im.real());
+			} else {
+				filtered = pairDot(&work[n]);
+			}
+			const double arg = -2.0*M_PI*ldexp(double(phase + uint64_t(n)*step), -64);
+			output.push_back(filtered*Complex(cos(arg), sin(arg)));
+		}
+		nextOutput = n - blockLen;
+		phase += uint64_t(blockLen)*step;
+
+		// Slide the newest histLen samples to the front for the next block
+		std::copy(work.begin()+blockLen, work.begin()+blockLen+histLen, work.begin());
+		done += blockLen;
+	}
+}
@@ -0,0 +1,95 @@
+/*
+ * This file is protected by Copyright. Please refer to the COPYRIGHT file distributed with this
+ * source distribution.
+ *
+ * This file is part of REDHAWK Basic Components TuneFilterDecimate.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this
+ * program.  If not, see http://www.gnu.org/licenses/.
+ */
+#ifndef BANDPASSDECIMATOR_H
+#define BANDPASSDECIMATOR_H
+
+#include <vector>
+#include <stdint.h>
+
+#include "DataTypes.h"
+#include "FirDotProduct.h"
+#include "InputSamples.h"
+#include "Mixer.h"
+
+/**************************************************************************
+
+    Tune after decimating: complex bandpass filter, decimate, then mix
+    the retained outputs down.
+
+    Mixing every input sample down by exp(-j*2*pi*f*n) and then lowpass
+    filtering gives the same output as filtering with the prototype
+    shifted up to the tuning frequency, h[k]*exp(j*2*pi*f*k), and mixing
+    only the filter output down (as the Channelizer does per channel).
+    Here the shifted filter is evaluated in direct form for the retained
+    outputs only, straight from the packet, so there is no mixer at the
+    input rate at all; the mixing is done at the output rate.
+
+    Real input needs no more arithmetic than the lowpass of complex data:
+    each sample is staged as (x, x) against the interleaved complex taps.
+    Complex input takes the real and imaginary parts of the taps as two
+    real filters, twice the arithmetic of the lowpass, so it only pays
+    off when the mixer costs more than the extra taps/decimation.
+
+    Retuning recomputes the shifted taps from the prototype; the output
+    has a transient of one filter length, as with retuning the tuner.
+
+ **************************************************************************/
+class BandpassDecimator
+{
+public:
+	BandpassDecimator(const RealVector& taps, size_t decimation, double tuningNorm, size_t blockSize=4096);
+
+	// Process the input samples, appending the retained outputs to output
+	void run(const InputSamples& input, ComplexVector& output);
+
+	void retune(double tuningNorm);
+
+	// Clear the filter history, decimation phase and mixer phase
+	void reset();
+
+	// Mixer phase in cycles, so a replacement can continue where this one left off
+	double getPhase() const;
+	void setPhase(double cycles);
+
+	// Start the mixer at sample n of the stream, see Mixer::seek.  The phase of every output
+	// is exact, as in Mixer, so the output does not depend on how the input was split up.
+	void seek(uint64_t n) { phase = n*step; }
+
+	size_t getNumTaps() const { return prototype.size(); }
+	size_t getDecimation() const { return decimation; }
+
+private:
+	// Shift the prototype up to tuningNorm
+	void shiftTaps();
+
+	RealVector prototype;
+	size_t decimation;
+	size_t blockSize;
+	size_t nextOutput;      // index in the next block of the next retained output
+	double tuningNorm;
+	uint64_t phase;         // mixer phase at the first sample of the next block, in 2^-64 cycles
+	uint64_t step;          // per sample, in 2^-64 cycles
+	bool complexHistory;    // work holds complex samples, rather than real ones as (x, x)
+	FirDotProduct realDot;  // real part of the shifted taps, for complex input
+	FirDotProduct imagDot;  // imaginary part of the shifted taps, for complex input
+	FirDotProduct pairDot;  // shifted taps, for real input
+	ComplexVector work;     // numTaps-1 samples of history followed by one block
+	std::vector<float> realBlock;
+};
+
+#endif
@@ -0,0 +1,133 @@
+/*
+ * This file is protected by Copyright. Please refer to the COPYRIGHT file distributed with this
+ * source distribution.
+ *
+ * This file is part of REDHAWK Basic Components TuneFilterDecimate.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this
+ * program.  If not, see http://www.gnu.org/licenses/.
+ */
+#include "BatchProcessor.h"
+
+#include <algorithm>
+#include <boost/bind.hpp>
+#include <boost/thread.hpp>
+
+#include "Mixer.h"
+#include "TfdEngine.h"
+
+namespace {
+	size_t gcd(size_t a, size_t b)
+	{
+		while (b != 0) {
+			const size_t r = a%b;
+			a = b;
+			b = r;
+		}
+		return a;
+	}
+
+	size_t roundUp(size_t value, size_t multiple)
+	{
+		return ((value + multiple - 1)/multiple)*multiple;
+	}
+}
+
+const size_t BatchProcessor::PACKET_SIZE;
+
+BatchProcessor::BatchProcessor(FilterChainBuilder &builder, const FilterDesign &design) :
+	builder(builder),
+	design(design),
+	numTaps(0),
+	decimation(1),
+	alignment(Mixer::BLOCK_SIZE),
+	warmup(0),
+	outputSamples(0)
+{
+}
+
+bool BatchProcessor::prepare()
+{
+	if (!design.channels.empty()) {
+		error = "batch processing is for a single channel";
+		return false;
+	}
+	FilterChainPtr chain = builder.build(design);
+	engine = chain->engine;
+	numTaps = chain->numTaps;
+	decimation = chain->decimation;
+	stages = chain->stages;
+	if ((chain->polyphase == NULL) && (chain->multistage == NULL) && (chain->fused == NULL) && (chain->bandpass == NULL)) {
+		error = engine + " output depends on where its blocks start; use the POLYPHASE, MULTISTAGE, FUSED or BANDPASS engine";
+		return false;
+	}
+
+	alignment = Mixer::BLOCK_SIZE/gcd(Mixer::BLOCK_SIZE, decimation)*decimation;
+	warmup = roundUp(chain->historyLength(), alignment);
+	return true;
+}
+
+void BatchProcessor::processChunk(const MappedCapture &capture, size_t start, size_t end, ComplexVector &output)
+{
+	// Both start and the warm-up are multiples of the alignment
+	const size_t first = start - std::min(start, warmup);
+	size_t skip = (start - first)/decimation;
+
+	TfdEngine engine(builder);
+	engine.configure(design);
+	engine.seek(first);
+
+	output.clear();
+	output.reserve((end - start)/decimation + 1);
+	std::vector<ComplexVector> packetOutput;
+	for (size_t pos = first; pos < end; pos += PACKET_SIZE) {
+		engine.process(capture.samples(pos, std::min(PACKET_SIZE, end-pos)), packetOutput);
+		const ComplexVector &retained = packetOutput[0];
+		const size_t dropped = std::min(skip, retained.size());
+		output.insert(output.end(), retained.begin()+dropped, retained.end());
+		skip -= dropped;
+	}
+}
+
+bool BatchProcessor::run(const MappedCapture &capture, FILE *output, size_t numThreads, size_t chunkSize)
+{
+	const size_t numSamples = capture.getNumSamples();
+	if (capture.isComplex() != design.inputComplex) {
+		error = "the design and the capture disagree on real or complex input";
+		return false;
+	}
+	numThreads = std::max(numThreads, size_t(1));
+	chunkSize = (chunkSize == 0) ? roundUp(std::max(numSamples, size_t(1)), alignment) : roundUp(chunkSize, alignment);
+	outputSamples = 0;
+
+	std::vector<ComplexVector> outputs(numThreads);
+	for (size_t roundStart = 0; roundStart < numSamples; ) {
+		boost::thread_group threads;
+		size_t numChunks = 0;
+		for (; (numChunks < numThreads) && (roundStart < numSamples); numChunks++) {
+			const size_t end = std::min(numSamples, roundStart + chunkSize);
+			threads.create_thread(boost::bind(&BatchProcessor::processChunk, this,
+					boost::cref(capture), roundStart, end, boost::ref(outputs[numChunks])));
+			roundStart = end;
+		}
+		threads.join_all();
+
+		for (size_t i=0; i < numChunks; i++) {
+			const size_t count = outputs[i].size();
+			if ((count != 0) && (fwrite(&outputs[i][0], sizeof(Complex), count, output) != count)) {
+				error = "write failed";
+				return false;
+			}
+			outputSamples += count;
+		}
+	}
+	return true;
+}
@@ -0,0 +1,96 @@
+/*
+ * This file is protected by Copyright. Please refer to the COPYRIGHT file distributed with this
+ * source distribution.
+ *
+ * This file is part of REDHAWK Basic Components TuneFilterDecimate.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this
+ * program.  If not, see http://www.gnu.org/licenses/.
+ */
+#ifndef BATCHPROCESSOR_H
+#define BATCHPROCESSOR_H
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+#include "DataTypes.h"
+#include "FilterChain.h"
+#include "FilterChainBuilder.h"
+#include "MappedCapture.h"
+
+/**************************************************************************
+
+    Tune, filter and decimate of a whole capture file, in chunks on
+    several threads, with the output identical to running it through one
+    TfdEngine from start to end.
+
+    Each chunk starts on a multiple of both the decimation and the mixer
+    block size, so its retained outputs and its mixer blocks fall on the
+    same samples as they would in one pass, and the mixer is started at
+    the exact phase of its first sample (see Mixer::seek; the BANDPASS
+    engine mixes its outputs from the same exact phase).  The filter
+    history is rebuilt by running each chunk from a warm-up stretch of the
+    previous one, at least as long as the filter, whose outputs are
+    dropped.  Only the time-domain engines are exact like this: the FFT
+    filter's rounding depends on where its blocks start, so FFT and
+    channelizer designs are refused.
+
+    The threads process one chunk each at a time, and the outputs are
+    written in order after each round, so memory use is bounded by the
+    chunk size times the number of threads.
+
+ **************************************************************************/
+class BatchProcessor
+{
+public:
+	// The builder must outlive the processor
+	BatchProcessor(FilterChainBuilder &builder, const FilterDesign &design);
+
+	// Build the chain once to check the design can be processed in chunks and size the
+	// warm-up; returns false with getError() set if it cannot
+	bool prepare();
+
+	// Process the whole capture, which must be complex if the design is, with numThreads threads and chunks of at least chunkSize
+	// samples, writing the output to the file as interleaved I/Q floats.  A chunkSize of 0
+	// processes the capture in one piece.
+	bool run(const MappedCapture &capture, FILE *output, size_t numThreads, size_t chunkSize);
+
+	const std::string& getError() const { return error; }
+
+	// Of the chain built by prepare()
+	const std::string& getEngine() const { return engine; }
+	size_t getNumTaps() const { return numTaps; }
+	size_t getDecimation() const { return decimation; }
+	const std::string& getStages() const { return stages; }
+
+	uint64_t getOutputSamples() const { return outputSamples; }
+
+	// Samples handed to the engine at a time, a multiple of Mixer::BLOCK_SIZE
+	static const size_t PACKET_SIZE = 65536;
+
+private:
+	void processChunk(const MappedCapture &capture, size_t start, size_t end, ComplexVector &output);
+
+	FilterChainBuilder &builder;
+	FilterDesign design;
+	std::string engine;
+	size_t numTaps;
+	size_t decimation;
+	std::string stages;
+	size_t alignment;   // chunks start on multiples of this
+	size_t warmup;      // samples run before a chunk to fill the filter history
+	uint64_t outputSamples;
+	std::string error;
+};
+
+#endif
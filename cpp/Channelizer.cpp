@@ -0,0 +1,137 @@
+/*
+ * This file is protected by Copyright. Please refer to the COPYRIGHT file distributed with this
+ * source distribution.
+ *
+ * This file is part of REDHAWK Basic Components TuneFilterDecimate.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this
+ * program.  If not, see http://www.gnu.org/licenses/.
+ */
+#include "Channelizer.h"
+#include "Mixer.h"
+
+#include <algorithm>
+#include <cmath>
+
+static fftwf_complex* fftw_cast(ComplexFFTWVector& vec)
+{
+	return reinterpret_cast<fftwf_complex*>(&vec[0]);
+}
+
+Channelizer::Channelizer(size_t fftSize, const std::vector<ChannelDesign>& designs) :
+	fftSize(fftSize),
+	overlap(0)
+{
+	for (size_t i=0; i < designs.size(); i++)
+		overlap = std::max(overlap, designs[i].taps.size());
+	if (overlap > 0)
+		overlap--;
+	if (this->fftSize <= overlap)
+		this->fftSize = 2*(overlap+1);
+
+	timeBuffer.assign(this->fftSize, Complex(0,0));
+	spectrum.resize(this->fftSize);
+	product.resize(this->fftSize);
+	filtered.resize(this->fftSize);
+	forwardPlan = fftwf_plan_dft_1d(this->fftSize, fftw_cast(timeBuffer), fftw_cast(spectrum), FFTW_FORWARD, FFTW_MEASURE);
+	inversePlan = fftwf_plan_dft_1d(this->fftSize, fftw_cast(product), fftw_cast(filtered), FFTW_BACKWARD, FFTW_MEASURE);
+
+	// Compute the response of each shifted prototype.  Planning may have
+	// scribbled on the buffers, so they are only filled in afterwards.
+	channels.resize(designs.size());
+	for (size_t i=0; i < designs.size(); i++) {
+		const ChannelDesign& design = designs[i];
+		Channel& channel = channels[i];
+		std::fill(timeBuffer.begin(), timeBuffer.end(), Complex(0,0));
+		for (size_t n=0; n < design.taps.size(); n++) {
+			double arg = 2.0*M_PI*fmod(design.tuningNorm*n, 1.0);
+			timeBuffer[n] = Complex(design.taps[n]*cos(arg), design.taps[n]*sin(arg));
+		}
+		channel.response.resize(this->fftSize);
+		fftwf_execute_dft(forwardPlan, fftw_cast(timeBuffer), fftw_cast(channel.response));
+		const float scale = 1.0/this->fftSize; // FFTW's inverse transform is unnormalized
+		for (size_t k=0; k < this->fftSize; k++)
+			channel.response[k] *= scale;
+		channel.decimation = std::max(design.decimation, size_t(1));
+		channel.nextOutput = 0;
+		channel.tuningNorm = design.tuningNorm;
+		channel.phase = 0.0;
+	}
+
+	std::fill(timeBuffer.begin(), timeBuffer.end(), Complex(0,0));
+	blockFill = overlap;
+}
+
+Channelizer::~Channelizer()
+{
+	fftwf_destroy_plan(forwardPlan);
+	fftwf_destroy_plan(inversePlan);
+}
+
+void Channelizer::reset()
+{
+	std::fill(timeBuffer.begin(), timeBuffer.end(), Complex(0,0));
+	blockFill = overlap;
+	for (size_t i=0; i < channels.size(); i++) {
+		channels[i].nextOutput = 0;
+		channels[i].phase = 0.0;
+	}
+}
+
+void Channelizer::seek(uint64_t n)
+{
+	// From the exact 64-bit phase, as in Mixer
+	for (size_t i=0; i < channels.size(); i++)
+		channels[i].phase = ldexp(double(Mixer::toFixed(channels[i].tuningNorm)*n), -64);
+}
+
+void Channelizer::run(const InputSamples& input, std::vector<ComplexVector>& output)
+{
+	output.resize(channels.size());
+	for (size_t done=0; done < input.numSamples; ) {
+		const size_t count = std::min(fftSize - blockFill, input.numSamples - done);
+		input.slice(done, count).toComplex(&timeBuffer[blockFill]);
+		blockFill += count;
+		done += count;
+		if (blockFill == fftSize)
+			processBlock(output);
+	}
+}
+
+void Channelizer::processBlock(std::vector<ComplexVector>& output)
+{
+	// The forward transform is shared by every channel
+	fftwf_execute(forwardPlan);
+
+	const size_t newSamples = fftSize - overlap;
+	for (size_t i=0; i < channels.size(); i++) {
+		Channel& channel = channels[i];
+		for (size_t k=0; k < fftSize; k++)
+			product[k] = spectrum[k]*channel.response[k];
+		fftwf_execute(inversePlan);
+
+		// filtered[overlap+n] is the bandpass output at the n-th new sample of the block
+		ComplexVector& out = output[i];
+		size_t n = channel.nextOutput;
+		for (; n < newSamples; n += channel.decimation) {
+			double arg = -2.0*M_PI*(channel.phase + channel.tuningNorm*n);
+			Complex mixer(cos(arg), sin(arg));
+			out.push_back(filtered[overlap+n]*mixer);
+		}
+		channel.nextOutput = n - newSamples;
+		channel.phase += channel.tuningNorm*newSamples;
+		channel.phase -= floor(channel.phase);
+	}
+
+	// Keep the newest overlap samples as history for the next block
+	std::copy(timeBuffer.end()-overlap, timeBuffer.end(), timeBuffer.begin());
+	blockFill = overlap;
+}
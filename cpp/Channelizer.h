@@ -0,0 +1,100 @@
+/*
+ * This file is protected by Copyright. Please refer to the COPYRIGHT file distributed with this
+ * source distribution.
+ *
+ * This file is part of REDHAWK Basic Components TuneFilterDecimate.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this
+ * program.  If not, see http://www.gnu.org/licenses/.
+ */
+#ifndef CHANNELIZER_H
+#define CHANNELIZER_H
+
+#include <vector>
+#include <stdint.h>
+#include <fftw3.h>
+
+#include "DataTypes.h"
+#include "InputSamples.h"
+#include "firfilter.h"
+
+/**************************************************************************
+
+    Multi-channel tune/filter/decimate sharing one forward FFT.
+
+    The input is filtered by overlap-save: each block of fftSize samples
+    (the newest fftSize-maxTaps+1 of them new) is transformed once, and
+    every channel multiplies that spectrum by its own filter response,
+    transforms back and keeps its valid samples.
+
+    Instead of tuning first, each channel uses the lowpass prototype
+    shifted up to its tuning frequency, h[n]*exp(j*2*pi*f*n).  Filtering
+    with the shifted prototype, decimating, and then mixing the retained
+    samples down by exp(-j*2*pi*f*n) gives exactly the same output as
+    tuning and then lowpass filtering, but the mixing is only done at the
+    output rate and the input spectrum can be shared by all channels.
+
+    FFTW planning is not thread safe, so channelizers must be constructed
+    under the same lock as any other filter.
+
+ **************************************************************************/
+class Channelizer
+{
+public:
+	struct ChannelDesign
+	{
+		RealVector taps;   // lowpass prototype
+		size_t decimation;
+		double tuningNorm; // tuning frequency normalized to the input rate
+	};
+
+	Channelizer(size_t fftSize, const std::vector<ChannelDesign>& designs);
+	~Channelizer();
+
+	// Process the input samples.  The retained outputs of channel k are appended to output[k].
+	void run(const InputSamples& input, std::vector<ComplexVector>& output);
+
+	// Clear the history, decimation phases and mixer phases; keeps the responses and plans
+	void reset();
+
+	// Start the mixers at sample n of the stream, see Mixer::seek.  Only before the first block.
+	void seek(uint64_t n);
+
+	size_t getNumChannels() const { return channels.size(); }
+	size_t getDecimation(size_t channel) const { return channels[channel].decimation; }
+	size_t getFftSize() const { return fftSize; }
+	size_t getNumTaps() const { return overlap+1; }
+
+private:
+	struct Channel
+	{
+		ComplexFFTWVector response; // spectrum of the shifted prototype, scaled by 1/fftSize
+		size_t decimation;
+		size_t nextOutput;          // index in the next block's new samples of the next retained output
+		double tuningNorm;
+		double phase;               // mixer phase at the first new sample of the next block, in cycles
+	};
+
+	void processBlock(std::vector<ComplexVector>& output);
+
+	size_t fftSize;
+	size_t overlap;   // history kept from the previous block: longest filter - 1
+	size_t blockFill; // samples currently in timeBuffer
+	ComplexFFTWVector timeBuffer;
+	ComplexFFTWVector spectrum;
+	ComplexFFTWVector product;
+	ComplexFFTWVector filtered;
+	fftwf_plan forwardPlan;
+	fftwf_plan inversePlan;
+	std::vector<Channel> channels;
+};
+
+#endif
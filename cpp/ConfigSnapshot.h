@@ -0,0 +1,87 @@
+/*
+ * This file is protected by Copyright. Please refer to the COPYRIGHT file distributed with this
+ * source distribution.
+ *
+ * This file is part of REDHAWK Basic Components TuneFilterDecimate.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this
+ * program.  If not, see http://www.gnu.org/licenses/.
+ */
+#ifndef CONFIGSNAPSHOT_H
+#define CONFIGSNAPSHOT_H
+
+#include <string>
+#include <vector>
+#include <boost/shared_ptr.hpp>
+
+#include "struct_props.h"
+
+/**************************************************************************
+
+    The configuration properties the data path depends on, as one
+    immutable value.
+
+    Property change listeners build a new snapshot from the property
+    members and publish it with an atomic pointer swap; the processing
+    threads load the latest one at the start of every packet.  Neither
+    side ever waits for the other: a snapshot is never modified once
+    published, and it is freed when the last stream lets go of it.
+
+    version changes on every publish.  tuningVersion and filterVersion
+    only change when the tuning or the filter have to be redone, so a
+    stream can tell from them what a new snapshot requires of it, the
+    same way the retune and remakeFilter flags used to be set.
+
+ **************************************************************************/
+struct ConfigSnapshot
+{
+	ConfigSnapshot() :
+		version(0),
+		tuningVersion(0),
+		filterVersion(0),
+		TuningNorm(0.0),
+		TuningIF(0.0),
+		TuningRF(0),
+		FilterBW(0.0),
+		DesiredOutputRate(0.0),
+		RationalResampling(false),
+		ResampleTolerance(0.0),
+		AutoFFTSize(false),
+		PartitionSize(0),
+		ShortOutputGain(32767.0f),
+		ShortOutputAGC(false)
+	{
+	}
+
+	unsigned int version;
+	unsigned int tuningVersion;
+	unsigned int filterVersion;
+
+	std::string TuneMode;
+	double TuningNorm;
+	double TuningIF;
+	CORBA::ULongLong TuningRF;
+	float FilterBW;
+	float DesiredOutputRate;
+	bool RationalResampling;
+	double ResampleTolerance;
+	filterProps_struct filterProps;
+	bool AutoFFTSize;
+	std::string FilterEngine;
+	CORBA::ULong PartitionSize;
+	std::vector<channel_struct> channels;
+	float ShortOutputGain;
+	bool ShortOutputAGC;
+};
+
+typedef boost::shared_ptr<const ConfigSnapshot> ConfigSnapshotPtr;
+
+#endif
@@ -0,0 +1,149 @@
+/*
+ * This file is protected by Copyright. Please refer to the COPYRIGHT file distributed with this
+ * source distribution.
+ *
+ * This file is part of REDHAWK Basic Components TuneFilterDecimate.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this
+ * program.  If not, see http://www.gnu.org/licenses/.
+ */
+#include "FftSizeSelector.h"
+
+#include <algorithm>
+#include <fstream>
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+#include "firfilter.h"
+#include "FilterCostModel.h"
+
+namespace {
+
+const size_t TIMING_BLOCKS = 8;
+const size_t TIMING_MIN_SAMPLES = 16384;
+const size_t TIMING_RUNS = 3;
+
+double elapsedNs(const boost::posix_time::ptime& start)
+{
+	return (boost::posix_time::microsec_clock::universal_time() - start).total_microseconds()*1e3;
+}
+
+typedef std::pair<double, size_t> RankedSize;
+
+}
+
+const size_t FftSizeSelector::TIMED_CANDIDATES;
+
+std::vector<size_t> FftSizeSelector::candidates(size_t minSize, size_t maxSize)
+{
+	std::vector<size_t> sizes;
+	for (size_t p2 = 1; p2 <= maxSize; p2 *= 2) {
+		for (size_t p3 = p2; p3 <= maxSize; p3 *= 3) {
+			for (size_t p5 = p3; p5 <= maxSize; p5 *= 5) {
+				if (p5 >= minSize)
+					sizes.push_back(p5);
+			}
+		}
+	}
+	std::sort(sizes.begin(), sizes.end());
+	return sizes;
+}
+
+size_t FftSizeSelector::select(size_t numTaps, size_t minSize, size_t maxSize)
+{
+	// Every block has to filter at least one new sample
+	std::vector<size_t> sizes = candidates(std::max(minSize, numTaps+1), maxSize);
+	if (sizes.empty())
+		return std::max(minSize, std::min(maxSize, 2*numTaps));
+
+	std::vector<RankedSize> ranked;
+	for (size_t i=0; i < sizes.size(); i++)
+		ranked.push_back(RankedSize(FilterCostModel::fftFlops(numTaps, sizes[i]), sizes[i]));
+	const size_t numTimed = std::min(TIMED_CANDIDATES, ranked.size());
+	std::partial_sort(ranked.begin(), ranked.begin()+numTimed, ranked.end());
+
+	size_t best = ranked[0].second;
+	double bestCost = -1;
+	for (size_t i=0; i < numTimed; i++) {
+		const size_t fftSize = ranked[i].second;
+		blockTime(fftSize);
+		const double cost = measuredCost(numTaps, fftSize);
+		if ((cost > 0) && ((bestCost < 0) || (cost < bestCost))) {
+			bestCost = cost;
+			best = fftSize;
+		}
+	}
+	return best;
+}
+
+double FftSizeSelector::measuredCost(size_t numTaps, size_t fftSize) const
+{
+	std::map<size_t, double>::const_iterator it = blockTimes.find(fftSize);
+	if ((it == blockTimes.end()) || (fftSize <= numTaps))
+		return 0.0;
+	return it->second/(fftSize - numTaps + 1);
+}
+
+double FftSizeSelector::blockTime(size_t fftSize)
+{
+	std::map<size_t, double>::iterator it = blockTimes.find(fftSize);
+	if (it != blockTimes.end())
+		return it->second;
+
+	// Half the FFT for the taps, the usual ratio; the block time hardly depends on it
+	const size_t numTaps = fftSize/2;
+	const size_t validPerBlock = fftSize - numTaps + 1;
+	const size_t numSamples = std::max(TIMING_BLOCKS*validPerBlock, TIMING_MIN_SAMPLES);
+	firfilter::realVector realOut;
+	firfilter::complexVector complexOut;
+	firfilter::realVector coeff(numTaps, 1.0f/numTaps);
+	firfilter::complexVector data(numSamples);
+	for (size_t i=0; i < numSamples; i++)
+		data[i] = Complex(float(i%7)-3.0f, float(i%5)-2.0f);
+	firfilter filter(fftSize, realOut, complexOut, coeff);
+
+	// Best of a few runs, the first of which warms up the caches
+	double ns = 0.0;
+	for (size_t run=0; run < TIMING_RUNS; run++) {
+		complexOut.clear();
+		boost::posix_time::ptime start = boost::posix_time::microsec_clock::universal_time();
+		filter.newComplexData(data);
+		const double runNs = elapsedNs(start);
+		ns = run ? std::min(ns, runNs) : runNs;
+	}
+
+	// A clock too coarse to time it leaves the size untimed rather than free
+	const double time = ns*validPerBlock/numSamples;
+	if (time > 0)
+		blockTimes[fftSize] = time;
+	return time;
+}
+
+bool FftSizeSelector::load(const std::string &filename)
+{
+	std::ifstream file(filename.c_str());
+	if (!file)
+		return false;
+	size_t fftSize;
+	double time;
+	while (file >> fftSize >> time) {
+		if (time > 0)
+			blockTimes[fftSize] = time;
+	}
+	return true;
+}
+
+bool FftSizeSelector::save(const std::string &filename) const
+{
+	std::ofstream file(filename.c_str());
+	for (std::map<size_t, double>::const_iterator it = blockTimes.begin(); it != blockTimes.end(); ++it)
+		file << it->first << " " << it->second << "\n";
+	return file.good();
+}
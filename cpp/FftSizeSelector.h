@@ -0,0 +1,73 @@
+/*
+ * This file is protected by Copyright. Please refer to the COPYRIGHT file distributed with this
+ * source distribution.
+ *
+ * This file is part of REDHAWK Basic Components TuneFilterDecimate.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this
+ * program.  If not, see http://www.gnu.org/licenses/.
+ */
+#ifndef FFTSIZESELECTOR_H
+#define FFTSIZESELECTOR_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+/**************************************************************************
+
+    Picks the FFT size of the overlap-save filter from measured timings.
+
+    Each block of an FFT of size N filters N-taps+1 new samples, so a
+    larger FFT spreads its overhead over more samples but costs more per
+    point, and falls out of cache sooner.  Where the balance lies depends
+    on the machine as much as on the taps, so the candidates are timed
+    rather than modelled.  FFTW is fast for any size whose only prime
+    factors are 2, 3 and 5, which fills in the gaps between the powers
+    of two (a power of two at least twice the taps can be close to four
+    times the taps, where 2.5 or 3 times would do).
+
+    The flop count of FilterCostModel ranks all the 2^a*3^b*5^c sizes
+    and the few best ones are timed by running a firfilter of that size.
+    The time of a block hardly depends on the taps, so it is kept per
+    size and reused for every tap count; load and save keep the timings
+    of a machine across restarts, like FFTW wisdom.
+
+    Not thread safe; timing creates FFTW plans, so the builder only
+    uses it under its planner lock.
+
+ **************************************************************************/
+class FftSizeSelector
+{
+public:
+	// Cheapest FFT size for numTaps taps, no smaller than minSize and no larger than maxSize
+	size_t select(size_t numTaps, size_t minSize, size_t maxSize);
+
+	// Measured ns per input sample of filtering with numTaps taps at fftSize; 0 if that size was never timed
+	double measuredCost(size_t numTaps, size_t fftSize) const;
+
+	bool load(const std::string &filename);
+	bool save(const std::string &filename) const;
+
+	// The sizes between minSize and maxSize with no prime factors other than 2, 3 and 5, in increasing order
+	static std::vector<size_t> candidates(size_t minSize, size_t maxSize);
+
+	// Sizes timed per selection, the best by flop count
+	static const size_t TIMED_CANDIDATES = 6;
+
+private:
+	// Time a block of fftSize, the first time it is asked for
+	double blockTime(size_t fftSize);
+
+	std::map<size_t, double> blockTimes; // ns per block, by FFT size
+};
+
+#endif
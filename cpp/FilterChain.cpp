@@ -0,0 +1,389 @@
+/*
+ * This file is protected by Copyright. Please refer to the COPYRIGHT file distributed with this
+ * source distribution.
+ *
+ * This file is part of REDHAWK Basic Components TuneFilterDecimate.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this
+ * program.  If not, see http://www.gnu.org/licenses/.
+ */
+#include "FilterChain.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+	size_t gcd(size_t a, size_t b)
+	{
+		while (b != 0) {
+			const size_t r = a%b;
+			a = b;
+			b = r;
+		}
+		return a;
+	}
+}
+
+const size_t FilterDesign::MAX_INTERPOLATION;
+
+size_t FilterDesign::decimationFor(double inputRate, double outputRate)
+{
+	if ((inputRate <= 0) || (outputRate <= 0))
+		return 1;
+	return size_t(std::max(floor(inputRate/outputRate), 1.0));
+}
+
+void FilterDesign::ratioFor(double inputRate, double outputRate, double tolerance, size_t &interpolation, size_t &decimation)
+{
+	interpolation = 1;
+	decimation = decimationFor(inputRate, outputRate);
+	if ((inputRate <= 0) || (outputRate <= 0))
+		return;
+
+	// The filter grows with L, so take the first L that is close enough
+	double bestError = -1;
+	for (size_t L=1; L <= MAX_INTERPOLATION; L++) {
+		const double M = floor(inputRate*L/outputRate + 0.5);
+		if (M < 1)
+			continue;
+		const double error = fabs(inputRate*L/M - outputRate)/outputRate;
+		if ((bestError < 0) || (error < bestError)) {
+			bestError = error;
+			interpolation = L;
+			decimation = size_t(M);
+		}
+		if (error <= tolerance)
+			break;
+	}
+}
+
+bool FilterDesign::setPassband(Real filterBW, Real transitionWidth)
+{
+/*
+ *                    ASCII ART to explain the filter design
+ *
+ *  Lowpass (Real filter)
+ *  ---------|
+ *           \
+ *            \
+ *             \
+ *              |
+ *  ----------------------------------
+ *  0        FL FL+tw   fsOut/2   fsIn/2
+ *
+ *  The basic gist is we tune first, then filter.
+ *  Then we filter
+ *  Then we decimate
+ *
+ *  This means the filter is a LOWPASS filter which must be designed given the INPUT sampling frequency.
+ *  The transition frequency happens at 1/2 the requested tune bandwidth.  Thus FL = FilterBW / 2.0.
+ *  We need the transition region to "finish" by fsOut/2 to avoid aliasing, so we do a check for that too.
+ *
+ */
+	FL = filterBW / 2.0;
+
+	//calculate the transition frequency necessary to avoid aliasing
+	this->transitionWidth = transitionWidth;
+	// (when resampling, before the lower of the input and output rates, which also keeps out the images)
+	Real maxTW = (std::min(inputRate, outputRate())/2.0)-FL;
+	if (channels.empty() && maxTW > 0 && maxTW < transitionWidth)
+	{
+		this->transitionWidth = maxTW;
+		return false;
+	}
+	return true;
+}
+
+FilterChain::FilterChain() :
+	filter(NULL),
+	decimate(NULL),
+	polyphase(NULL),
+	multistage(NULL),
+	fused(NULL),
+	bandpass(NULL),
+	channelizer(NULL),
+	resampler(NULL),
+	partitioned(NULL),
+	decimation(1),
+	interpolation(1),
+	numTaps(0),
+	fftSize(0),
+	bytesPerSample(0.0),
+	costPerSample(0.0),
+	started(false),
+	startSample(0)
+{
+}
+
+FilterChain::~FilterChain()
+{
+	delete filter;
+	delete decimate;
+	delete polyphase;
+	delete multistage;
+	delete fused;
+	delete bandpass;
+	delete channelizer;
+	delete resampler;
+	delete partitioned;
+}
+
+void FilterChain::run(const InputSamples& input, firfilter::complexVector& tuned)
+{
+	output.resize((channelizer != NULL) ? channelizer->getNumChannels() : 1);
+	outputCount.resize(output.size(), 0);
+	skipOutputs.resize(output.size(), 0);
+	sizeBefore.resize(output.size());
+	for (size_t k=0; k < output.size(); k++)
+		sizeBefore[k] = output[k].size();
+
+	runEngines(input, tuned);
+
+	// Count what was produced, and drop what the chain before this one produced already
+	for (size_t k=0; k < output.size(); k++) {
+		const size_t produced = output[k].size() - sizeBefore[k];
+		outputCount[k] += produced;
+		const size_t skip = size_t(std::min(skipOutputs[k], uint64_t(produced)));
+		if (skip != 0) {
+			output[k].erase(output[k].begin()+sizeBefore[k], output[k].begin()+sizeBefore[k]+skip);
+			skipOutputs[k] -= skip;
+		}
+	}
+}
+
+void FilterChain::runEngines(const InputSamples& input, firfilter::complexVector& tuned)
+{
+
+	if (channelizer != NULL) {
+		// One forward FFT of the input is shared by every channel
+		if (input.numSamples != 0)
+			channelizer->run(input, output);
+		return;
+	}
+	if (fused != NULL) {
+		// Mix, filter and decimate straight from the packet into the output buffer
+		if (input.numSamples != 0)
+			fused->run(input, output[0]);
+		return;
+	}
+	if (bandpass != NULL) {
+		// Filter and decimate straight from the packet, then mix the retained outputs down
+		if (input.numSamples != 0)
+			bandpass->run(input, output[0]);
+		return;
+	}
+
+	if (polyphase != NULL) {
+		// Run Polyphase Decimator: only computes the retained outputs, straight into the output buffer
+		if (!tuned.empty())
+			polyphase->run(&tuned[0], tuned.size(), output[0]);
+	} else if (resampler != NULL) {
+		// Run the rational resampler, straight into the output buffer
+		if (!tuned.empty())
+			resampler->run(&tuned[0], tuned.size(), output[0]);
+	} else if (partitioned != NULL) {
+		// Run the partitioned filter, straight into the output buffer
+		if (!tuned.empty())
+			partitioned->run(&tuned[0], tuned.size(), output[0]);
+	} else if (multistage != NULL) {
+		// Run the cascade of polyphase stages, the last one writing into the output buffer
+		if (!tuned.empty())
+			multistage->run(&tuned[0], tuned.size(), output[0]);
+	} else {
+		// Run Filter: fills up f_<type>Out vector
+		filter->newComplexData(tuned); // Tuner always outputs complex data in current implementation.
+
+		size_t buffLen_1 = f_complexOut.size(); // Size the rest of the buffers according to the filtered data.
+		if (buffLen_1 !=0)
+		{
+			decimateOutput.reserve((buffLen_1+decimation-1)/decimation);
+			// Run Decimation: fills up decimateOutput vector
+			decimate->run();
+		}
+
+		// Decimate is bound to decimateOutput, so trade storage with the output buffer rather than copying
+		if (output[0].empty())
+			output[0].swap(decimateOutput);
+		else
+			output[0].insert(output[0].end(), decimateOutput.begin(), decimateOutput.end());
+		decimateOutput.clear();
+	}
+}
+
+void FilterChain::retune(double tuningNorm)
+{
+	if (fused != NULL)
+		fused->retune(tuningNorm);
+	if (bandpass != NULL)
+		bandpass->retune(tuningNorm);
+}
+
+double FilterChain::getPhase() const
+{
+	if (fused != NULL)
+		return fused->getPhase();
+	if (bandpass != NULL)
+		return bandpass->getPhase();
+	return 0.0;
+}
+
+void FilterChain::setPhase(double cycles)
+{
+	if (fused != NULL)
+		fused->setPhase(cycles);
+	if (bandpass != NULL)
+		bandpass->setPhase(cycles);
+}
+
+void FilterChain::seek(uint64_t n)
+{
+	if (fused != NULL)
+		fused->seek(n);
+	if (bandpass != NULL)
+		bandpass->seek(n);
+}
+
+void FilterChain::clearOutput()
+{
+	for (size_t i=0; i < output.size(); i++)
+		output[i].clear();
+}
+
+void FilterChain::resetHistory()
+{
+	if (polyphase != NULL)
+		polyphase->reset();
+	if (multistage != NULL)
+		multistage->reset();
+	if (fused != NULL)
+		fused->reset();
+	if (bandpass != NULL)
+		bandpass->reset();
+	if (channelizer != NULL)
+		channelizer->reset();
+	if (resampler != NULL)
+		resampler->reset();
+	if (partitioned != NULL)
+		partitioned->reset();
+	clearOutput();
+	started = false;
+	startSample = 0;
+	outputCount.clear();
+	skipOutputs.clear();
+}
+
+size_t FilterChain::historyLength() const
+{
+	if (channelizer != NULL)
+		return channelizer->getFftSize(); // a full block has to go through before the first output
+	if (fused != NULL)
+		return fused->getNumTaps();
+	if (bandpass != NULL)
+		return bandpass->getNumTaps();
+	if (polyphase != NULL)
+		return polyphase->getNumTaps();
+	if (multistage != NULL)
+		return multistage->getHistoryLength();
+	if (resampler != NULL)
+		return resampler->getHistoryLength();
+	if (partitioned != NULL)
+		return partitioned->getHistoryLength();
+	return filterCoeff.size() + fftSize;
+}
+
+size_t FilterChain::gridPeriod() const
+{
+	if (channelizer == NULL)
+		return std::max(decimation, size_t(1));
+	size_t period = 1;
+	for (size_t k=0; k < channelizer->getNumChannels(); k++)
+		period = period/gcd(period, channelizer->getDecimation(k))*channelizer->getDecimation(k);
+	return period;
+}
+
+size_t FilterChain::outputDecimation(size_t k) const
+{
+	return (channelizer != NULL) ? channelizer->getDecimation(k) : std::max(decimation, size_t(1));
+}
+
+void FilterChain::start(uint64_t n, bool complexInput)
+{
+	output.resize((channelizer != NULL) ? channelizer->getNumChannels() : 1);
+	outputCount.assign(output.size(), 0);
+	skipOutputs.assign(output.size(), 0);
+	const size_t numZeros = size_t(n % gridPeriod());
+	startSample = n - numZeros;
+	started = true;
+	if (channelizer != NULL)
+		channelizer->seek(startSample);
+	if (numZeros == 0)
+		return;
+
+	// The zeros contribute nothing to the output whatever the mixer phase, which is put back after them
+	const double phase = getPhase();
+	std::vector<float> zeros((complexInput ? 2 : 1)*numZeros, 0.0f);
+	firfilter::complexVector tunedZeros(numZeros, Complex(0,0));
+	run(InputSamples(&zeros[0], numZeros, complexInput), tunedZeros);
+	clearOutput();
+	setPhase(phase);
+}
+
+uint64_t FilterChain::nextOutput(size_t k) const
+{
+	const uint64_t produced = (k < outputCount.size()) ? outputCount[k] : 0;
+	return startSample*interpolation/outputDecimation(k) + produced;
+}
+
+void FilterChain::continueFrom(const FilterChain& previous)
+{
+	if (!previous.started || (previous.output.size() != output.size()) || (previous.interpolation != interpolation))
+		return;
+	for (size_t k=0; k < output.size(); k++) {
+		if (previous.outputDecimation(k) != outputDecimation(k))
+			return;
+	}
+
+	for (size_t k=0; k < output.size(); k++) {
+		// output[k] holds the newest outputs this chain produced, up to nextOutput(k)
+		const uint64_t held = output[k].size();
+		const uint64_t next = previous.nextOutput(k);
+		const uint64_t firstHeld = nextOutput(k) - held;
+		if (next < firstHeld)
+			continue; // not held back far enough; cannot happen after a full warm-up
+		const uint64_t drop = next - firstHeld;
+		if (drop <= held) {
+			output[k].erase(output[k].begin(), output[k].begin()+size_t(drop));
+		} else {
+			output[k].clear();
+			skipOutputs[k] = drop - held;
+		}
+	}
+}
+
+void FilterChain::holdOutput(const FilterChain& current)
+{
+	for (size_t k=0; k < output.size(); k++) {
+		const size_t keep = current.latency()*interpolation/outputDecimation(k) + 2;
+		if (output[k].size() > keep)
+			output[k].erase(output[k].begin(), output[k].end()-keep);
+	}
+}
+
+size_t FilterChain::latency() const
+{
+	if (channelizer != NULL)
+		return channelizer->getFftSize() - channelizer->getNumTaps() + 1;
+	if (partitioned != NULL)
+		return partitioned->getLatency();
+	if (filter != NULL)
+		return fftSize - filterCoeff.size() + 1;
+	return 0;
+}
@@ -0,0 +1,233 @@
+/*
+ * This file is protected by Copyright. Please refer to the COPYRIGHT file distributed with this
+ * source distribution.
+ *
+ * This file is part of REDHAWK Basic Components TuneFilterDecimate.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this
+ * program.  If not, see http://www.gnu.org/licenses/.
+ */
+#ifndef FILTERCHAIN_H
+#define FILTERCHAIN_H
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include <boost/shared_ptr.hpp>
+
+#include "DataTypes.h"
+#include "InputSamples.h"
+#include "firfilter.h"
+#include "Decimate.h"
+#include "PolyphaseDecimator.h"
+#include "MultistageDecimator.h"
+#include "FusedTfdKernel.h"
+#include "BandpassDecimator.h"
+#include "Channelizer.h"
+#include "RationalResampler.h"
+#include "PartitionedFilter.h"
+
+// One channel of the multi-channel mode, as set by the channels property
+struct ChannelSpec
+{
+	ChannelSpec(double tuningIF=0.0, double filterBW=0.0, double outputRate=0.0) :
+		tuningIF(tuningIF),
+		filterBW(filterBW),
+		outputRate(outputRate)
+	{
+	}
+
+	double tuningIF;
+	double filterBW;
+	double outputRate; // requested; the decimation is the input rate over it, rounded down
+};
+
+// Everything needed to build a filter chain, copied from the properties and
+// the stream under the component lock so that it can be built without it
+struct FilterDesign
+{
+	FilterDesign() :
+		inputRate(0.0),
+		inputComplex(true),
+		decimation(1),
+		interpolation(1),
+		FL(0),
+		transitionWidth(0),
+		ripple(0),
+		fftSize(0),
+		autoFftSize(false),
+		partitionSize(1024),
+		tuningNorm(0.0)
+	{
+	}
+
+	std::string engine; // requested FilterEngine
+	double inputRate;
+	bool inputComplex;
+	size_t decimation;
+	size_t interpolation; // rational resampling by interpolation/decimation when more than 1
+	Real FL;
+	Real transitionWidth;
+	Real ripple;
+	size_t fftSize;
+	bool autoFftSize;   // pick the FFT size of the single channel filter by timing, ignoring fftSize
+	size_t partitionSize; // block size of the PARTITIONED engine
+	double tuningNorm;
+	std::vector<ChannelSpec> channels; // multi-channel mode when not empty
+
+	// Decimation that gives the output rate closest to, and no lower than, the requested one
+	static size_t decimationFor(double inputRate, double outputRate);
+
+	// Smallest interpolation L, up to MAX_INTERPOLATION, and decimation M for which
+	// inputRate*L/M is within tolerance (relative) of outputRate, or the closest one
+	static void ratioFor(double inputRate, double outputRate, double tolerance, size_t &interpolation, size_t &decimation);
+	static const size_t MAX_INTERPOLATION = 1024;
+
+	double outputRate() const { return inputRate*interpolation/decimation; }
+
+	// Set the lowpass for filterBW, from the input and output rates.  The transition width is
+	// reduced if needed to keep aliases out of the passband; returns false when it was.
+	bool setPassband(Real filterBW, Real transitionWidth);
+};
+
+/**************************************************************************
+
+    The filter and decimator of one stream, with the buffers bound to them.
+
+    This is everything after the tuner, or everything for the fused kernel,
+    the bandpass decimator and the channelizer which do their own mixing.  The output rate is
+    the input rate times interpolation/decimation.  Exactly one of the
+    engines is set.  A stream replaces its chain as a unit, so a new one
+    can be designed and planned on another thread while the current one
+    keeps running, and then be swapped in at a packet boundary.
+
+    The processing classes keep references to the buffers, so a chain must
+    stay at a fixed address for its whole life (streams hold it by pointer).
+
+    Every chain of a stream decimates on the same grid: start() lines its
+    first input up on a multiple of gridPeriod() samples of the stream by
+    feeding it zeros first, so retained output k of any chain is the one
+    at the same stream sample.  A chain counts the outputs it produces, so
+    when it replaces another, continueFrom() can drop the ones the other
+    chain already produced and keep the held ones it did not, and the
+    output goes on with neither duplicates nor gaps, whatever the latency
+    of either chain.
+
+ **************************************************************************/
+class FilterChain
+{
+public:
+	FilterChain();
+	~FilterChain();
+
+	// True when the chain reads the tuner output rather than the packet itself
+	bool needsTuner() const { return (fused == NULL) && (bandpass == NULL) && (channelizer == NULL); }
+
+	// True when the chain does the tuning itself (the fused kernel and the bandpass decimator),
+	// which is then set through the chain.  The mixer phase is in cycles.
+	bool tunesInput() const { return (fused != NULL) || (bandpass != NULL); }
+	void retune(double tuningNorm);
+	double getPhase() const;
+	void setPhase(double cycles);
+	void seek(uint64_t n);
+
+	// Process one packet.  tuned is the tuner output for the same samples as input, only
+	// used when needsTuner().  The output is appended to output[0], or to output[k] for
+	// channel k of the channelizer.
+	void run(const InputSamples& input, firfilter::complexVector& tuned);
+
+	void clearOutput();
+
+	// Start over from an empty filter history, keeping the taps and plans.  Only the engines
+	// that can do this in place; see FilterChainBuilder::reset() for the FFT filter.
+	void resetHistory();
+
+	// Input samples the chain must see before its output no longer depends on its initial state
+	size_t historyLength() const;
+
+	// Input samples the chain collects before it produces the outputs they contribute to: a block
+	// for the FFT based engines, none for the direct forms.  The wait for the next retained output
+	// and the group delay of the filter come on top of this.
+	size_t latency() const;
+
+	// Input samples after which the retained outputs of every output stream fall on the same
+	// samples again: the decimation, or the least common multiple of the channel decimations
+	size_t gridPeriod() const;
+	size_t outputDecimation(size_t k) const;
+
+	// Start the chain at sample n of the stream: it is first fed the n mod gridPeriod() zeros
+	// before n, keeping its mixer phase, so that its outputs fall on the grid of the stream
+	void start(uint64_t n, bool complexInput);
+
+	// Stream index, in output samples, of the next output the chain produces on output k
+	uint64_t nextOutput(size_t k) const;
+
+	// Take over from previous, which stopped before the current packet: the outputs held in
+	// output (see holdOutput) that previous produced already are dropped, and so are those
+	// produced from now on until the chain catches up with previous.  Nothing is done when
+	// the two do not decimate alike.
+	void continueFrom(const FilterChain& previous);
+
+	// Keep only the newest outputs of a chain that is warming up alongside current: as many as
+	// current may still owe for the input seen so far (see latency())
+	void holdOutput(const FilterChain& current);
+
+	// Engines
+	firfilter *filter;
+	Decimate *decimate;
+	PolyphaseDecimator *polyphase;
+	MultistageDecimator *multistage;
+	FusedTfdKernel *fused;
+	BandpassDecimator *bandpass;
+	Channelizer *channelizer;
+	RationalResampler *resampler;
+	PartitionedFilter *partitioned;
+
+	// Buffers of the FFT filter and decimator.  All of these are REQUIRED by firfilter's
+	// constructor, whether we are filtering real or complex data.  DO NOT REMOVE.
+	firfilter::realVector f_realOut;
+	firfilter::complexVector f_complexOut;
+	RealFFTWVector filterCoeff;
+	ComplexVector decimateOutput;
+
+	// Written by the engines in place, then handed to the output port by OutputBufferPool::share()
+	std::vector<ComplexVector> output;
+
+	// The design, for the readonly properties and the output SRI
+	std::string engine;
+	size_t decimation;
+	size_t interpolation;
+	size_t numTaps;
+	size_t fftSize;
+	std::string stages;
+	double bytesPerSample;
+	double costPerSample;  // estimated ns per input sample, see FilterCostModel
+	std::vector<ChannelSpec> channels;
+
+	// Position in the stream, kept by the filter stage (see start())
+	bool started;
+	uint64_t startSample;              // stream sample of the first (zero) input, on the grid
+	std::vector<uint64_t> outputCount; // outputs produced so far, per output
+	std::vector<uint64_t> skipOutputs; // outputs still to drop as they are produced, per output
+
+private:
+	void runEngines(const InputSamples& input, firfilter::complexVector& tuned);
+
+	std::vector<size_t> sizeBefore;   // of each output, while running
+
+	// Not copyable: the engines are bound to this object's buffers
+	FilterChain(const FilterChain&);
+	FilterChain& operator= (const FilterChain&);
+};
+
+typedef boost::shared_ptr<FilterChain> FilterChainPtr;
+
+#endif
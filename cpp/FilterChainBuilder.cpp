@@ -0,0 +1,355 @@
+/*
+ * This file is protected by Copyright. Please refer to the COPYRIGHT file distributed with this
+ * source distribution.
+ *
+ * This file is part of REDHAWK Basic Components TuneFilterDecimate.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this
+ * program.  If not, see http://www.gnu.org/licenses/.
+ */
+#include "FilterChainBuilder.h"
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <boost/bind.hpp>
+
+//set allowed bounds here for static members to make the compilers happy
+const size_t FilterChainBuilder::MIN_NUM_TAPS= 25;
+const size_t FilterChainBuilder::MAX_NUM_TAPS= 4*1024*1024;
+const size_t FilterChainBuilder::MIN_FFT_SIZE= 64;
+const size_t FilterChainBuilder::MAX_FFT_SIZE= 8*1024*1024;
+
+namespace {
+
+//find the power of 2 greater then or equal to the input number
+size_t pow2ge(size_t n)
+{
+	size_t out=2;
+	while (n>out)
+		out*=2;
+	return out;
+}
+
+}
+
+FilterChainBuilder::FilterChainBuilder()
+{
+}
+
+void FilterChainBuilder::calibrate()
+{
+	boost::mutex::scoped_lock lock(plannerLock);
+	costModel.calibrate();
+}
+
+void FilterChainBuilder::setCacheCapacity(size_t capacity)
+{
+	boost::mutex::scoped_lock lock(designLock);
+	cache.setCapacity(capacity);
+}
+
+void FilterChainBuilder::getCacheCounters(size_t &hits, size_t &misses)
+{
+	boost::mutex::scoped_lock lock(designLock);
+	hits = cache.getHits();
+	misses = cache.getMisses();
+}
+
+bool FilterChainBuilder::importWisdom(const std::string &filename)
+{
+	boost::mutex::scoped_lock lock(plannerLock);
+	return FilterDesignCache::importWisdom(filename);
+}
+
+bool FilterChainBuilder::exportWisdom(const std::string &filename)
+{
+	boost::mutex::scoped_lock lock(plannerLock);
+	return FilterDesignCache::exportWisdom(filename);
+}
+
+bool FilterChainBuilder::loadFftTimings(const std::string &filename)
+{
+	boost::mutex::scoped_lock lock(plannerLock);
+	return fftSizes.load(filename);
+}
+
+bool FilterChainBuilder::saveFftTimings(const std::string &filename)
+{
+	boost::mutex::scoped_lock lock(plannerLock);
+	return fftSizes.save(filename);
+}
+
+size_t FilterChainBuilder::designLowpass(RealVector &taps, Real ripple, Real transitionWidth, Real FL, Real inputRate, size_t fftSize)
+{
+	FilterDesignCache::Key key(inputRate, 2.0*FL, transitionWidth, ripple, fftSize);
+	if (!cache.lookup(key, taps)) {
+		designer.wdfirHz(taps, FIRFilter::lowpass, ripple, transitionWidth, FL, 0, inputRate, MIN_NUM_TAPS, MAX_NUM_TAPS);
+		cache.insert(key, taps);
+	}
+	return taps.size();
+}
+
+FilterChainPtr FilterChainBuilder::build(const FilterDesign &design)
+{
+	FilterChainPtr chain(new FilterChain(), boost::bind(&FilterChainBuilder::destroy, this, _1));
+	chain->decimation = design.decimation;
+	chain->interpolation = design.interpolation;
+	chain->channels = design.channels;
+
+	if (!design.channels.empty()) {
+		chain->interpolation = 1;
+		buildChannelizer(design, *chain);
+		return chain;
+	}
+
+	// Only the polyphase form does fractional rates
+	if (design.interpolation > 1) {
+		buildResampler(design, *chain);
+		return chain;
+	}
+
+	// Large decimation factors are cheaper as a cascade of stages; otherwise design a single lowpass
+	if (buildMultistage(design, *chain))
+		return chain;
+
+	// We generate our FIR filter taps here. The read-only property 'taps' is set from the chain.
+	// 	- We use the transition width and ripple specified by the user to create the filter taps.
+	// 	- Normalized lowpass cutoff frequency is the only one we need; upper cutoff not used
+	RealVector tmpVec;
+	{
+		boost::mutex::scoped_lock lock(designLock);
+		// The configured FFT size does not apply when it is chosen by timing
+		const size_t keyFftSize = design.autoFftSize ? 0 : design.fftSize;
+		chain->numTaps = designLowpass(tmpVec, design.ripple, design.transitionWidth, design.FL, design.inputRate, keyFftSize);
+	}
+	RealFFTWVector &filterCoeff = chain->filterCoeff;
+	filterCoeff.clear();
+	filterCoeff.reserve(tmpVec.size());
+	for (RealVector::iterator i = tmpVec.begin(); i!=tmpVec.end(); i++)
+		filterCoeff.push_back(*i);
+
+	// Minimum FFT_size implemented
+	chain->fftSize = design.fftSize;
+	size_t minFftSize = std::max(MIN_FFT_SIZE, pow2ge(2*chain->numTaps));
+	const bool timeFftSize = design.autoFftSize && ((design.engine == "FFT") || (design.engine == "AUTO"));
+	if (timeFftSize) {
+		boost::mutex::scoped_lock lock(plannerLock);
+		chain->fftSize = fftSizes.select(chain->numTaps, MIN_FFT_SIZE, MAX_FFT_SIZE);
+	} else if(chain->fftSize < minFftSize)
+		chain->fftSize = minFftSize;
+	else if (chain->fftSize > MAX_FFT_SIZE)
+		chain->fftSize = MAX_FFT_SIZE;
+	chain->engine = selectFilterEngine(design.engine, chain->numTaps, chain->fftSize, design.decimation, design.inputComplex,
+			chain->costPerSample);
+	if (timeFftSize && (chain->engine == "FFT")) {
+		// Timed rather than estimated
+		boost::mutex::scoped_lock lock(plannerLock);
+		const double measured = fftSizes.measuredCost(chain->numTaps, chain->fftSize);
+		if (measured > 0)
+			chain->costPerSample = measured;
+	}
+	if (chain->engine == "FUSED") {
+		chain->fused = new FusedTfdKernel(tmpVec, design.decimation, design.tuningNorm);
+	} else if (chain->engine == "BANDPASS") {
+		chain->bandpass = new BandpassDecimator(tmpVec, design.decimation, design.tuningNorm);
+	} else if (chain->engine == "POLYPHASE") {
+		chain->polyphase = new PolyphaseDecimator(tmpVec, design.decimation);
+	} else if (chain->engine == "PARTITIONED") {
+		// Not bound to an FFT size, so that filterProps.FFT_size is left alone
+		const size_t blockSize = std::min(std::max(design.partitionSize, size_t(1)), MAX_FFT_SIZE/2);
+		{
+			boost::mutex::scoped_lock lock(plannerLock);
+			chain->partitioned = new PartitionedFilter(tmpVec, design.decimation, blockSize);
+		}
+		chain->fftSize = 0;
+		chain->costPerSample = costModel.partitionedCost(chain->numTaps, blockSize);
+	} else {
+		boost::mutex::scoped_lock lock(plannerLock);
+		chain->filter = new firfilter(chain->fftSize, chain->f_realOut, chain->f_complexOut, filterCoeff);
+		chain->decimate = new Decimate(chain->f_complexOut, chain->decimateOutput, design.decimation);
+	}
+	chain->bytesPerSample = estimateBytesPerSample(chain->engine, design.inputComplex, design.decimation);
+	chain->stages = MultistageDecimator::describe(std::vector<size_t>(1, design.decimation), std::vector<size_t>(1, chain->numTaps));
+	return chain;
+}
+
+void FilterChainBuilder::reset(FilterChain &chain)
+{
+	chain.resetHistory();
+	if (chain.filter == NULL)
+		return;
+
+	// firfilter cannot clear its overlap, so it is replaced by one on the same taps.  FFTW
+	// has the plan of that size as wisdom already, so this takes no measuring.
+	boost::mutex::scoped_lock lock(plannerLock);
+	delete chain.filter;
+	delete chain.decimate;
+	chain.f_realOut.clear();
+	chain.f_complexOut.clear();
+	chain.decimateOutput.clear();
+	chain.filter = new firfilter(chain.fftSize, chain.f_realOut, chain.f_complexOut, chain.filterCoeff);
+	chain.decimate = new Decimate(chain.f_complexOut, chain.decimateOutput, chain.decimation);
+}
+
+void FilterChainBuilder::destroy(FilterChain *chain)
+{
+	// Destroying the FFT filter or the channelizer destroys FFTW plans
+	boost::mutex::scoped_lock lock(plannerLock);
+	delete chain;
+}
+
+size_t FilterChainBuilder::channelDecimation(const ChannelSpec &channel, double inputRate)
+{
+	if (channel.outputRate <= 0)
+		return 1;
+	return FilterDesign::decimationFor(inputRate, channel.outputRate);
+}
+
+void FilterChainBuilder::buildChannelizer(const FilterDesign &design, FilterChain &chain)
+{
+	// Every channel gets the same lowpass design as the single channel filter, using
+	// its own bandwidth and output rate, while filterProps is shared by all of them
+	std::vector<Channelizer::ChannelDesign> channelDesigns(design.channels.size());
+	size_t maxTaps = 0;
+	{
+		boost::mutex::scoped_lock lock(designLock);
+		for (size_t i=0; i < design.channels.size(); i++) {
+			const ChannelSpec &channel = design.channels[i];
+			Channelizer::ChannelDesign &channelDesign = channelDesigns[i];
+			channelDesign.decimation = channelDecimation(channel, design.inputRate);
+			channelDesign.tuningNorm = (design.inputRate > 0) ? (channel.tuningIF / design.inputRate) : 0.0;
+
+			Real FL = channel.filterBW / 2.0;
+			Real transitionWidth = design.transitionWidth;
+			Real maxTW = (design.inputRate/channelDesign.decimation/2.0)-FL;
+			if (maxTW > 0 && maxTW < transitionWidth)
+				transitionWidth = maxTW;
+			size_t numTaps = designLowpass(channelDesign.taps, design.ripple, transitionWidth, FL, design.inputRate, design.fftSize);
+			maxTaps = std::max(maxTaps, numTaps);
+		}
+	}
+
+	size_t fftSize = std::max(design.fftSize, std::max(MIN_FFT_SIZE, pow2ge(2*maxTaps)));
+	fftSize = std::min(fftSize, MAX_FFT_SIZE);
+	{
+		boost::mutex::scoped_lock lock(plannerLock);
+		chain.channelizer = new Channelizer(fftSize, channelDesigns);
+	}
+	chain.engine = "CHANNELIZER";
+	chain.numTaps = maxTaps;
+	chain.fftSize = fftSize;
+}
+
+std::string FilterChainBuilder::selectFilterEngine(const std::string& requested, size_t numTaps, size_t fftSize, size_t decimation,
+		bool inputComplex, double &cost)
+{
+	double directCost = costModel.directCost(numTaps, decimation);
+	double fftCost = costModel.fftCost(numTaps, fftSize);
+	double bandpassCost = costModel.bandpassCost(numTaps, decimation, inputComplex);
+	if (requested != "AUTO") {
+		if (requested == "BANDPASS")
+			cost = bandpassCost;
+		else
+			cost = ((requested == "POLYPHASE") || (requested == "FUSED")) ? directCost : fftCost;
+		return requested;
+	}
+
+	// When only the retained outputs are computed, the fused kernel does the
+	// same arithmetic as the polyphase decimator without the full rate buffers.
+	// The bandpass decimator has no mixer at the input rate, which the others
+	// pay for on top of their filter.
+	const double mixerCost = costModel.mixerCost();
+	if (bandpassCost < std::min(directCost, fftCost) + mixerCost) {
+		cost = bandpassCost;
+		return "BANDPASS";
+	}
+	cost = std::min(directCost, fftCost);
+	return (directCost < fftCost) ? "FUSED" : "FFT";
+}
+
+void FilterChainBuilder::buildResampler(const FilterDesign &design, FilterChain &chain)
+{
+	// The prototype runs at the upsampled rate
+	RealVector taps;
+	{
+		boost::mutex::scoped_lock lock(designLock);
+		chain.numTaps = designLowpass(taps, design.ripple, design.transitionWidth, design.FL,
+				design.inputRate*design.interpolation, 0);
+	}
+	chain.resampler = new RationalResampler(taps, design.interpolation, design.decimation);
+	chain.engine = "RESAMPLER";
+
+	std::ostringstream stages;
+	stages << design.interpolation << "/" << design.decimation << " taps " << chain.numTaps;
+	chain.stages = stages.str();
+	chain.bytesPerSample = estimateBytesPerSample("RESAMPLER", design.inputComplex, design.decimation);
+
+	// Taps/L per output and L/M outputs per input sample: the work of a decimator by M with all the taps
+	chain.costPerSample = costModel.directCost(chain.numTaps, design.decimation);
+}
+
+bool FilterChainBuilder::buildMultistage(const FilterDesign &design, FilterChain &chain)
+{
+	if ((design.engine != "MULTISTAGE") && (design.engine != "AUTO"))
+		return false;
+
+	std::vector<MultistageDecimator::StagePlan> stagePlan = MultistageDecimator::plan(design.decimation, design.inputRate, design.FL,
+			design.transitionWidth, design.ripple, MIN_NUM_TAPS);
+	if (stagePlan.empty())
+		return false;
+
+	if (design.engine == "AUTO") {
+		// Only worth it if it beats the best single stage design
+		if (stagePlan.size() < 2)
+			return false;
+		size_t singleTaps = MultistageDecimator::estimateTaps(design.inputRate, design.transitionWidth, design.ripple, MIN_NUM_TAPS);
+		size_t singleFftSize = std::max(design.fftSize, pow2ge(2*singleTaps));
+		double singleCost = std::min(costModel.directCost(singleTaps, design.decimation), costModel.fftCost(singleTaps, singleFftSize));
+		if (costModel.multistageCost(stagePlan) >= singleCost)
+			return false;
+	}
+
+	// The passband ripple of the stages adds up, so each stage gets its share
+	std::vector<RealVector> stageTaps(stagePlan.size());
+	std::vector<size_t> decimations;
+	std::vector<size_t> numTaps;
+	{
+		boost::mutex::scoped_lock lock(designLock);
+		for (size_t i=0; i < stagePlan.size(); i++) {
+			numTaps.push_back(designLowpass(stageTaps[i], design.ripple/stagePlan.size(), stagePlan[i].transitionWidth,
+					design.FL, stagePlan[i].inputRate, 0));
+			decimations.push_back(stagePlan[i].decimation);
+			stagePlan[i].estimatedTaps = numTaps.back();
+		}
+	}
+	chain.multistage = new MultistageDecimator(stageTaps, decimations);
+	chain.engine = "MULTISTAGE";
+	chain.numTaps = chain.multistage->getNumTaps();
+	chain.stages = MultistageDecimator::describe(decimations, numTaps);
+	chain.bytesPerSample = estimateBytesPerSample("MULTISTAGE", design.inputComplex, design.decimation);
+	chain.costPerSample = costModel.multistageCost(stagePlan);
+	return true;
+}
+
+double FilterChainBuilder::estimateBytesPerSample(const std::string& engine, bool inputComplex, size_t decimation)
+{
+	// Bytes moved per input sample: the input read, then a write and a read of every full rate
+	// complex buffer, then the decimated output (written, re-read to interleave, written interleaved)
+	double inputBytes = inputComplex ? 2*sizeof(float) : sizeof(float);
+	double sampleBytes = sizeof(Complex);
+	double outputBytes = 3*sampleBytes/decimation;
+	if ((engine == "FUSED") || (engine == "BANDPASS"))
+		return inputBytes + sampleBytes/decimation;
+	if ((engine == "POLYPHASE") || (engine == "MULTISTAGE") || (engine == "RESAMPLER") || (engine == "PARTITIONED"))
+		return inputBytes + 2*sampleBytes + outputBytes; // f_complexIn; later stages run at a reduced rate
+	return inputBytes + 4*sampleBytes + outputBytes;     // f_complexIn, f_complexOut
+}
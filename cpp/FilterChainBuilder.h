@@ -0,0 +1,118 @@
+/*
+ * This file is protected by Copyright. Please refer to the COPYRIGHT file distributed with this
+ * source distribution.
+ *
+ * This file is part of REDHAWK Basic Components TuneFilterDecimate.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this
+ * program.  If not, see http://www.gnu.org/licenses/.
+ */
+#ifndef FILTERCHAINBUILDER_H
+#define FILTERCHAINBUILDER_H
+
+#include <string>
+#include <vector>
+#include <boost/thread/mutex.hpp>
+
+#include "DataTypes.h"
+#include "FirFilterDesigner.h"
+#include "FilterChain.h"
+#include "FilterCostModel.h"
+#include "FilterDesignCache.h"
+#include "FftSizeSelector.h"
+
+/**************************************************************************
+
+    Designs the lowpass filters of a FilterDesign and builds the
+    FilterChain that runs them, with the engine FilterDesign::engine asks
+    for, or the cheapest one for AUTO.  A design that interpolates
+    (interpolation > 1) always gets the RationalResampler.
+
+    This is the whole configuration side of the processing, free of the
+    REDHAWK properties, ports and SRI the component drives it from, so
+    the benchmark builds exactly the chains the component would.  It is
+    thread safe: the filter designer and the design cache are guarded by
+    one lock, and everything that creates or destroys an FFTW plan by
+    another, since FFTW's planner is not thread safe.
+
+ **************************************************************************/
+class FilterChainBuilder
+{
+public:
+	FilterChainBuilder();
+
+	// Time the direct and FFT filter forms on this machine, see FilterCostModel
+	void calibrate();
+	const FilterCostModel& getCostModel() const { return costModel; }
+
+	// Build the chain for a design; the chain must not outlive the builder, which destroys
+	// its FFTW plans under the planner lock
+	FilterChainPtr build(const FilterDesign &design);
+
+	// Clear the filter history (and the mixer phase of the fused kernel) of a chain this builder
+	// built, without designing or planning anything new
+	void reset(FilterChain &chain);
+
+	void setCacheCapacity(size_t capacity);
+	void getCacheCounters(size_t &hits, size_t &misses);
+
+	// FFTW wisdom, see FilterDesignCache
+	bool importWisdom(const std::string &filename);
+	bool exportWisdom(const std::string &filename);
+
+	// Timings of the automatic FFT size selection, see FftSizeSelector
+	bool loadFftTimings(const std::string &filename);
+	bool saveFftTimings(const std::string &filename);
+
+	// Decimation of a channel of the multi-channel mode
+	static size_t channelDecimation(const ChannelSpec &channel, double inputRate);
+
+	// Main memory traffic model for the engines that use intermediate full rate buffers
+	static double estimateBytesPerSample(const std::string& engine, bool inputComplex, size_t decimation);
+
+	static const size_t MIN_NUM_TAPS;
+	static const size_t MAX_NUM_TAPS;
+	static const size_t MIN_FFT_SIZE;
+	static const size_t MAX_FFT_SIZE;
+
+private:
+	void destroy(FilterChain *chain);
+
+	// Design a lowpass with wdfirHz, or take it from the design cache; returns # of taps.
+	// Must be called with designLock held.
+	size_t designLowpass(RealVector &taps, Real ripple, Real transitionWidth, Real FL, Real inputRate, size_t fftSize);
+
+	// Multi-channel mode: build the shared-FFT channelizer
+	void buildChannelizer(const FilterDesign &design, FilterChain &chain);
+
+	// Rational resampling: design the prototype at the upsampled rate and build the RationalResampler
+	void buildResampler(const FilterDesign &design, FilterChain &chain);
+
+	// Build the multistage decimator if the MULTISTAGE engine is selected, or if AUTO finds it cheapest
+	bool buildMultistage(const FilterDesign &design, FilterChain &chain);
+
+	// Decide between the FFT filter + Decimate chain, the polyphase decimator, the fused kernel and
+	// the bandpass decimator; cost is set to the estimated ns per input sample of the engine returned
+	std::string selectFilterEngine(const std::string& requested, size_t numTaps, size_t fftSize, size_t decimation,
+			bool inputComplex, double &cost);
+
+	FirFilterDesigner designer;
+	FilterDesignCache cache;
+	FilterCostModel costModel;  // calibrated once, read-only afterwards
+	FftSizeSelector fftSizes;   // guarded by plannerLock, since it times FFTW plans
+
+	// Guards designer and cache
+	boost::mutex designLock;
+	// FFTW's planner is not thread safe: held to create or destroy anything with an FFTW plan
+	boost::mutex plannerLock;
+};
+
+#endif
@@ -0,0 +1,128 @@
+/*
+ * This file is protected by Copyright. Please refer to the COPYRIGHT file distributed with this
+ * source distribution.
+ *
+ * This file is part of REDHAWK Basic Components TuneFilterDecimate.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this
+ * program.  If not, see http://www.gnu.org/licenses/.
+ */
+#include "FilterCostModel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+#include "firfilter.h"
+#include "PolyphaseDecimator.h"
+
+const double FilterCostModel::NOMINAL_NS_PER_FLOP = 0.25;
+const double FilterCostModel::MIXER_FLOPS = 12.0;
+
+namespace {
+
+// Calibration design: a short filter with moderate decimation, where the two forms are close
+const size_t CAL_TAPS = 64;
+const size_t CAL_DECIMATION = 8;
+const size_t CAL_FFT_SIZE = 1024;
+const size_t CAL_SAMPLES = 65536;
+const size_t CAL_RUNS = 3;
+
+double elapsedNs(const boost::posix_time::ptime& start)
+{
+	return (boost::posix_time::microsec_clock::universal_time() - start).total_microseconds()*1e3;
+}
+
+}
+
+FilterCostModel::FilterCostModel() :
+	directNsPerFlop(NOMINAL_NS_PER_FLOP),
+	fftNsPerFlop(NOMINAL_NS_PER_FLOP),
+	calibrated(false)
+{
+}
+
+double FilterCostModel::directFlops(size_t numTaps, size_t decimation)
+{
+	// One real*complex multiply-accumulate per tap, but only for every decimation-th sample
+	return 4.0*numTaps/std::max(decimation, size_t(1));
+}
+
+double FilterCostModel::fftFlops(size_t numTaps, size_t fftSize)
+{
+	// A forward and inverse complex FFT plus the spectral multiply for every
+	// (fftSize - numTaps + 1) new samples
+	double validPerBlock = fftSize - numTaps + 1;
+	return (10.0*fftSize*log2(double(fftSize)) + 6.0*fftSize)/validPerBlock;
+}
+
+double FilterCostModel::partitionedFlops(size_t numTaps, size_t blockSize)
+{
+	// A forward and inverse complex FFT of twice the block size, plus a complex
+	// multiply-accumulate per partition, for every blockSize new samples
+	blockSize = std::max(blockSize, size_t(1));
+	double fftSize = 2.0*blockSize;
+	double numPartitions = (numTaps + blockSize - 1)/blockSize;
+	return (10.0*fftSize*log2(fftSize) + 8.0*numPartitions*fftSize)/blockSize;
+}
+
+double FilterCostModel::bandpassFlops(size_t numTaps, size_t decimation, bool inputComplex)
+{
+	// Complex taps: a complex*complex multiply-accumulate per tap for complex input, the same
+	// as the lowpass for real input, plus the mixing of every retained output
+	const double tapFlops = inputComplex ? 8.0 : 4.0;
+	return (tapFlops*numTaps + MIXER_FLOPS)/std::max(decimation, size_t(1));
+}
+
+void FilterCostModel::calibrate()
+{
+	RealVector taps(CAL_TAPS, 1.0f/CAL_TAPS);
+	ComplexVector input(CAL_SAMPLES);
+	for (size_t i=0; i < CAL_SAMPLES; i++)
+		input[i] = Complex(float(i%7)-3.0f, float(i%5)-2.0f);
+
+	// Best of a few runs, the first of which warms up the caches
+	double directNs = 0.0;
+	{
+		PolyphaseDecimator decimator(taps, CAL_DECIMATION);
+		ComplexVector output;
+		for (size_t run=0; run < CAL_RUNS; run++) {
+			output.clear();
+			boost::posix_time::ptime start = boost::posix_time::microsec_clock::universal_time();
+			decimator.run(&input[0], input.size(), output);
+			double ns = elapsedNs(start);
+			directNs = run ? std::min(directNs, ns) : ns;
+		}
+	}
+
+	double fftNs = 0.0;
+	{
+		firfilter::realVector realOut;
+		firfilter::complexVector complexOut;
+		firfilter::realVector coeff(taps.begin(), taps.end());
+		firfilter::complexVector data(input.begin(), input.end());
+		firfilter filter(CAL_FFT_SIZE, realOut, complexOut, coeff);
+		for (size_t run=0; run < CAL_RUNS; run++) {
+			complexOut.clear();
+			boost::posix_time::ptime start = boost::posix_time::microsec_clock::universal_time();
+			filter.newComplexData(data);
+			double ns = elapsedNs(start);
+			fftNs = run ? std::min(fftNs, ns) : ns;
+		}
+	}
+
+	// The clock may be too coarse on some systems; keep the nominal values then
+	if ((directNs <= 0.0) || (fftNs <= 0.0))
+		return;
+	directNsPerFlop = directNs/(directFlops(CAL_TAPS, CAL_DECIMATION)*CAL_SAMPLES);
+	fftNsPerFlop = fftNs/(fftFlops(CAL_TAPS, CAL_FFT_SIZE)*CAL_SAMPLES);
+	calibrated = true;
+}
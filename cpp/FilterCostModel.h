@@ -0,0 +1,83 @@
+/*
+ * This file is protected by Copyright. Please refer to the COPYRIGHT file distributed with this
+ * source distribution.
+ *
+ * This file is part of REDHAWK Basic Components TuneFilterDecimate.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this
+ * program.  If not, see http://www.gnu.org/licenses/.
+ */
+#ifndef FILTERCOSTMODEL_H
+#define FILTERCOSTMODEL_H
+
+#include <vector>
+
+#include "MultistageDecimator.h"
+
+/**************************************************************************
+
+    Estimated processing time per input sample of the two forms the
+    lowpass filter can take: direct form, computing only the retained
+    outputs (POLYPHASE, FUSED and every stage of MULTISTAGE), and FFT
+    overlap-save followed by decimation (FFT).
+
+    The flop counts alone favour the FFT too early: the direct form runs
+    at close to the SIMD peak, while FFTs are held back by memory access
+    and the full rate output buffers.  calibrate() times both forms on a
+    fixed design once, and each form's flops are then weighted by the
+    time per flop it actually achieved on this machine.  Until then, both
+    use NOMINAL_NS_PER_FLOP and the choice is by flop count.  The
+    partitioned filter (PARTITIONED) is costed at the FFT time per flop,
+    the bandpass decimator (BANDPASS) at the direct form time per flop.
+
+ **************************************************************************/
+class FilterCostModel
+{
+public:
+	FilterCostModel();
+
+	// Time both forms; creates an FFTW plan, so must be called with the planner lock held
+	void calibrate();
+
+	// Flops per input sample
+	static double directFlops(size_t numTaps, size_t decimation);
+	static double fftFlops(size_t numTaps, size_t fftSize);
+	static double partitionedFlops(size_t numTaps, size_t blockSize);
+	static double bandpassFlops(size_t numTaps, size_t decimation, bool inputComplex);
+	static const double MIXER_FLOPS; // per input sample, of the tuner the other forms need
+
+	// Estimated nanoseconds per input sample
+	double directCost(size_t numTaps, size_t decimation) const { return directNsPerFlop*directFlops(numTaps, decimation); }
+	double fftCost(size_t numTaps, size_t fftSize) const { return fftNsPerFlop*fftFlops(numTaps, fftSize); }
+	double partitionedCost(size_t numTaps, size_t blockSize) const { return fftNsPerFlop*partitionedFlops(numTaps, blockSize); }
+	double bandpassCost(size_t numTaps, size_t decimation, bool inputComplex) const
+	{
+		return directNsPerFlop*bandpassFlops(numTaps, decimation, inputComplex);
+	}
+	double mixerCost() const { return directNsPerFlop*MIXER_FLOPS; }
+	double multistageCost(const std::vector<MultistageDecimator::StagePlan>& stages) const
+	{
+		return directNsPerFlop*MultistageDecimator::cost(stages);
+	}
+
+	bool isCalibrated() const { return calibrated; }
+	double getDirectNsPerFlop() const { return directNsPerFlop; }
+	double getFftNsPerFlop() const { return fftNsPerFlop; }
+
+	static const double NOMINAL_NS_PER_FLOP;
+
+private:
+	double directNsPerFlop;
+	double fftNsPerFlop;
+	bool calibrated;
+};
+
+#endif
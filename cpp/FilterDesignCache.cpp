@@ -0,0 +1,100 @@
+/*
+ * This file is protected by Copyright. Please refer to the COPYRIGHT file distributed with this
+ * source distribution.
+ *
+ * This file is part of REDHAWK Basic Components TuneFilterDecimate.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this
+ * program.  If not, see http://www.gnu.org/licenses/.
+ */
+#include "FilterDesignCache.h"
+
+#include <fftw3.h>
+
+bool FilterDesignCache::Key::operator< (const Key& other) const
+{
+	if (inputRate != other.inputRate)
+		return inputRate < other.inputRate;
+	if (filterBW != other.filterBW)
+		return filterBW < other.filterBW;
+	if (transitionWidth != other.transitionWidth)
+		return transitionWidth < other.transitionWidth;
+	if (ripple != other.ripple)
+		return ripple < other.ripple;
+	return fftSize < other.fftSize;
+}
+
+FilterDesignCache::FilterDesignCache(size_t capacity) :
+	capacity(capacity),
+	hits(0),
+	misses(0)
+{
+}
+
+bool FilterDesignCache::lookup(const Key& key, RealVector& taps)
+{
+	EntryMap::iterator it = entries.find(key);
+	if (it == entries.end()) {
+		misses++;
+		return false;
+	}
+	hits++;
+	usage.splice(usage.begin(), usage, it->second.usage);
+	taps = it->second.taps;
+	return true;
+}
+
+void FilterDesignCache::insert(const Key& key, const RealVector& taps)
+{
+	if (capacity == 0)
+		return;
+	EntryMap::iterator it = entries.find(key);
+	if (it != entries.end()) {
+		it->second.taps = taps;
+		usage.splice(usage.begin(), usage, it->second.usage);
+		return;
+	}
+	usage.push_front(key);
+	Entry& entry = entries[key];
+	entry.taps = taps;
+	entry.usage = usage.begin();
+	evict();
+}
+
+void FilterDesignCache::setCapacity(size_t capacity)
+{
+	this->capacity = capacity;
+	evict();
+}
+
+void FilterDesignCache::clear()
+{
+	entries.clear();
+	usage.clear();
+}
+
+void FilterDesignCache::evict()
+{
+	while (entries.size() > capacity) {
+		entries.erase(usage.back());
+		usage.pop_back();
+	}
+}
+
+bool FilterDesignCache::importWisdom(const std::string& filename)
+{
+	return fftwf_import_wisdom_from_filename(filename.c_str()) != 0;
+}
+
+bool FilterDesignCache::exportWisdom(const std::string& filename)
+{
+	return fftwf_export_wisdom_to_filename(filename.c_str()) != 0;
+}
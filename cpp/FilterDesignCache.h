@@ -0,0 +1,105 @@
+/*
+ * This file is protected by Copyright. Please refer to the COPYRIGHT file distributed with this
+ * source distribution.
+ *
+ * This file is part of REDHAWK Basic Components TuneFilterDecimate.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this
+ * program.  If not, see http://www.gnu.org/licenses/.
+ */
+#ifndef FILTERDESIGNCACHE_H
+#define FILTERDESIGNCACHE_H
+
+#include <list>
+#include <map>
+#include <string>
+
+#include "DataTypes.h"
+
+/**************************************************************************
+
+    Bounded cache of designed filter taps.
+
+    Every filter remake runs the window design again, which for long
+    filters takes much longer than the packet it delays, while in practice
+    a component only hops between a few configurations.  Designs are kept
+    in least recently used order up to a fixed number of entries.
+
+    The FFT plans cannot be shared between filters since each firfilter
+    owns the buffers it plans against, but FFTW remembers everything it
+    has measured as wisdom, so a second plan of the same size is
+    immediately available.  importWisdom/exportWisdom persist that wisdom
+    so a restarted component does not have to measure again.
+
+    Not thread safe; FilterChainBuilder only uses it under its designLock,
+    which the builder thread also takes, outside the component lock.
+
+ **************************************************************************/
+class FilterDesignCache
+{
+public:
+	struct Key
+	{
+		Key(double inputRate, double filterBW, double transitionWidth, double ripple, size_t fftSize) :
+			inputRate(inputRate),
+			filterBW(filterBW),
+			transitionWidth(transitionWidth),
+			ripple(ripple),
+			fftSize(fftSize)
+		{
+		}
+
+		bool operator< (const Key& other) const;
+
+		double inputRate;
+		double filterBW;
+		double transitionWidth;
+		double ripple;
+		size_t fftSize;
+	};
+
+	FilterDesignCache(size_t capacity=16);
+
+	// Copy the taps designed for key into taps and return true, or return false if not cached
+	bool lookup(const Key& key, RealVector& taps);
+	void insert(const Key& key, const RealVector& taps);
+
+	// Shrinking the capacity drops the least recently used designs
+	void setCapacity(size_t capacity);
+	void clear();
+
+	size_t size() const { return entries.size(); }
+	size_t getHits() const { return hits; }
+	size_t getMisses() const { return misses; }
+
+	// FFTW wisdom for the single precision plans; both return false on failure
+	static bool importWisdom(const std::string& filename);
+	static bool exportWisdom(const std::string& filename);
+
+private:
+	typedef std::list<Key> UsageList;
+	struct Entry
+	{
+		RealVector taps;
+		UsageList::iterator usage;
+	};
+	typedef std::map<Key, Entry> EntryMap;
+
+	void evict();
+
+	size_t capacity;
+	size_t hits;
+	size_t misses;
+	EntryMap entries;
+	UsageList usage; // most recently used first
+};
+
+#endif
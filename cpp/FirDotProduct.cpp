@@ -0,0 +1,160 @@
+/*
+ * This file is protected by Copyright. Please refer to the COPYRIGHT file distributed with this
+ * source distribution.
+ *
+ * This file is part of REDHAWK Basic Components TuneFilterDecimate.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this
+ * program.  If not, see http://www.gnu.org/licenses/.
+ */
+#include "FirDotProduct.h"
+
+#if defined(__SSE__)
+#include <xmmintrin.h>
+#endif
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+
+// AVX kernel compiled for its own target and picked at run time, as in Mixer.cpp
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__) && ((__GNUC__ > 4) || ((__GNUC__ == 4) && (__GNUC_MINOR__ >= 9)))
+#define FIRDOT_HAVE_AVX
+#include <immintrin.h>
+#endif
+
+namespace {
+
+// Even floats are I, odd floats are Q
+inline Complex dotTail(const float* h, const float* x, size_t i, size_t len, float re, float im)
+{
+	for (; i < len; i += 2) {
+		re += h[i]*x[i];
+		im += h[i+1]*x[i+1];
+	}
+	return Complex(re, im);
+}
+
+Complex dotPortable(const float* h, const float* x, size_t len)
+{
+	// Separate accumulators for I and Q so the compiler can vectorize the loop
+	return dotTail(h, x, 0, len, 0.0f, 0.0f);
+}
+
+#if defined(__SSE__)
+Complex dotSse(const float* h, const float* x, size_t len)
+{
+	// Two accumulators of {I,Q,I,Q} hide the latency of the adds
+	__m128 acc0 = _mm_setzero_ps();
+	__m128 acc1 = _mm_setzero_ps();
+	size_t i = 0;
+	for (; i+8 <= len; i += 8) {
+		acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(h+i), _mm_loadu_ps(x+i)));
+		acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(h+i+4), _mm_loadu_ps(x+i+4)));
+	}
+	if (i+4 <= len) {
+		acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(h+i), _mm_loadu_ps(x+i)));
+		i += 4;
+	}
+	float sum[4];
+	_mm_storeu_ps(sum, _mm_add_ps(acc0, acc1));
+	return dotTail(h, x, i, len, sum[0]+sum[2], sum[1]+sum[3]);
+}
+#endif
+
+#if defined(FIRDOT_HAVE_AVX)
+__attribute__((target("avx")))
+Complex dotAvx(const float* h, const float* x, size_t len)
+{
+	__m256 acc0 = _mm256_setzero_ps();
+	__m256 acc1 = _mm256_setzero_ps();
+	size_t i = 0;
+	for (; i+16 <= len; i += 16) {
+		acc0 = _mm256_add_ps(acc0, _mm256_mul_ps(_mm256_loadu_ps(h+i), _mm256_loadu_ps(x+i)));
+		acc1 = _mm256_add_ps(acc1, _mm256_mul_ps(_mm256_loadu_ps(h+i+8), _mm256_loadu_ps(x+i+8)));
+	}
+	if (i+8 <= len) {
+		acc0 = _mm256_add_ps(acc0, _mm256_mul_ps(_mm256_loadu_ps(h+i), _mm256_loadu_ps(x+i)));
+		i += 8;
+	}
+	acc0 = _mm256_add_ps(acc0, acc1);
+	__m128 acc = _mm_add_ps(_mm256_castps256_ps128(acc0), _mm256_extractf128_ps(acc0, 1));
+	float sum[4];
+	_mm_storeu_ps(sum, acc);
+	return dotTail(h, x, i, len, sum[0]+sum[2], sum[1]+sum[3]);
+}
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+Complex dotNeon(const float* h, const float* x, size_t len)
+{
+	float32x4_t acc0 = vdupq_n_f32(0.0f);
+	float32x4_t acc1 = vdupq_n_f32(0.0f);
+	size_t i = 0;
+	for (; i+8 <= len; i += 8) {
+		acc0 = vmlaq_f32(acc0, vld1q_f32(h+i), vld1q_f32(x+i));
+		acc1 = vmlaq_f32(acc1, vld1q_f32(h+i+4), vld1q_f32(x+i+4));
+	}
+	if (i+4 <= len) {
+		acc0 = vmlaq_f32(acc0, vld1q_f32(h+i), vld1q_f32(x+i));
+		i += 4;
+	}
+	float sum[4];
+	vst1q_f32(sum, vaddq_f32(acc0, acc1));
+	return dotTail(h, x, i, len, sum[0]+sum[2], sum[1]+sum[3]);
+}
+#endif
+
+}
+
+FirDotProduct::FirDotProduct(const RealVector& taps)
+{
+	pairedTaps.reserve(2*taps.size());
+	for (RealVector::const_reverse_iterator tap = taps.rbegin(); tap != taps.rend(); ++tap) {
+		pairedTaps.push_back(*tap);
+		pairedTaps.push_back(*tap);
+	}
+	if (pairedTaps.empty())
+		pairedTaps.assign(2, 1.0f);
+	selectKernel();
+}
+
+FirDotProduct::FirDotProduct(const ComplexVector& taps)
+{
+	pairedTaps.reserve(2*taps.size());
+	for (ComplexVector::const_reverse_iterator tap = taps.rbegin(); tap != taps.rend(); ++tap) {
+		pairedTaps.push_back(tap->real());
+		pairedTaps.push_back(tap->imag());
+	}
+	if (pairedTaps.empty())
+		pairedTaps.assign(2, 1.0f);
+	selectKernel();
+}
+
+void FirDotProduct::selectKernel()
+{
+	kernel = &dotPortable;
+	kernelName = "portable";
+#if defined(__SSE__)
+	kernel = &dotSse;
+	kernelName = "SSE";
+#endif
+#if defined(FIRDOT_HAVE_AVX)
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx")) {
+		kernel = &dotAvx;
+		kernelName = "AVX";
+	}
+#endif
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+	kernel = &dotNeon;
+	kernelName = "NEON";
+#endif
+}
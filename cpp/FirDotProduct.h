@@ -0,0 +1,71 @@
+/*
+ * This file is protected by Copyright. Please refer to the COPYRIGHT file distributed with this
+ * source distribution.
+ *
+ * This file is part of REDHAWK Basic Components TuneFilterDecimate.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this
+ * program.  If not, see http://www.gnu.org/licenses/.
+ */
+#ifndef FIRDOTPRODUCT_H
+#define FIRDOTPRODUCT_H
+
+#include <vector>
+
+#include "DataTypes.h"
+
+/**************************************************************************
+
+    Direct form FIR output: the dot product of real taps with a window
+    of complex samples.
+
+    This is all the arithmetic of the decimators that only compute the
+    retained outputs (PolyphaseDecimator, FusedTfdKernel and the stages
+    of MultistageDecimator).  The taps are stored time-reversed with every
+    tap repeated for I and Q, so an output is a plain multiply-accumulate
+    of two float arrays, done with SIMD registers of interleaved I/Q.
+    Like the Mixer, the kernel is picked when the object is constructed:
+    AVX on CPUs that have it, SSE on other x86 CPUs, NEON on ARM, and
+    portable code elsewhere.
+
+ **************************************************************************/
+class FirDotProduct
+{
+public:
+	explicit FirDotProduct(const RealVector& taps);
+
+	// Complex taps, for a window of real samples each given as (x, x): the output is then the
+	// complex dot product of the taps with the real samples (see BandpassDecimator)
+	explicit FirDotProduct(const ComplexVector& taps);
+
+	// Filter output whose input window starts at window[0] and ends at window[size()-1]
+	Complex operator()(const Complex* window) const
+	{
+		return kernel(&pairedTaps[0], reinterpret_cast<const float*>(window), pairedTaps.size());
+	}
+
+	size_t size() const { return pairedTaps.size()/2; }
+
+	// Name of the SIMD kernel in use
+	const char* getKernelName() const { return kernelName; }
+
+	// Dot product of len floats of taps and interleaved I/Q samples
+	typedef Complex (*Kernel)(const float* taps, const float* x, size_t len);
+
+private:
+	void selectKernel();
+
+	std::vector<float> pairedTaps;  // time-reversed taps, each one twice (or as re, im when complex)
+	Kernel kernel;
+	const char* kernelName;
+};
+
+#endif
@@ -0,0 +1,79 @@
+/*
+ * This file is protected by Copyright. Please refer to the COPYRIGHT file distributed with this
+ * source distribution.
+ *
+ * This file is part of REDHAWK Basic Components TuneFilterDecimate.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this
+ * program.  If not, see http://www.gnu.org/licenses/.
+ */
+#include "FusedTfdKernel.h"
+
+#include <algorithm>
+#include <cmath>
+
+FusedTfdKernel::FusedTfdKernel(const RealVector& taps, size_t decimation, double tuningNorm, size_t blockSize) :
+	dot(taps),
+	decimation(std::max(decimation, size_t(1))),
+	nextOutput(0),
+	mixer(tuningNorm),
+	bytesRead(0),
+	bytesWritten(0),
+	samplesProcessed(0)
+{
+	// The history is slid to the front of the working buffer once per block,
+	// so keep blocks at least as long as the history
+	this->blockSize = std::max(blockSize, dot.size());
+	work.assign(dot.size()-1 + this->blockSize, Complex(0,0));
+}
+
+void FusedTfdKernel::reset()
+{
+	std::fill(work.begin(), work.end(), Complex(0,0));
+	nextOutput = 0;
+	mixer.reset();
+}
+
+double FusedTfdKernel::getBytesPerSample() const
+{
+	if (samplesProcessed == 0)
+		return 0.0;
+	return (bytesRead + bytesWritten)/samplesProcessed;
+}
+
+void FusedTfdKernel::run(const InputSamples& input, ComplexVector& output)
+{
+	const size_t histLen = dot.size()-1;
+	const size_t numSamples = input.numSamples;
+	size_t numOutputs = 0;
+
+	output.reserve(output.size() + (numSamples + decimation - 1)/decimation + 1);
+	for (size_t done = 0; done < numSamples; ) {
+		const size_t blockLen = std::min(blockSize, numSamples - done);
+		mixer.run(input.slice(done, blockLen), &work[histLen]);
+
+		// The window of the output at block index n is work[n .. n+histLen]
+		size_t n = nextOutput;
+		for (; n < blockLen; n += decimation) {
+			output.push_back(dot(&work[n]));
+			numOutputs++;
+		}
+		nextOutput = n - blockLen;
+
+		// Slide the newest histLen samples to the front for the next block
+		std::copy(work.begin()+blockLen, work.begin()+blockLen+histLen, work.begin());
+		done += blockLen;
+	}
+
+	bytesRead += numSamples*input.scalarsPerSample()*input.bytesPerScalar();
+	bytesWritten += numOutputs*2*sizeof(float);
+	samplesProcessed += numSamples;
+}
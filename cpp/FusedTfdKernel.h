@@ -0,0 +1,84 @@
+/*
+ * This file is protected by Copyright. Please refer to the COPYRIGHT file distributed with this
+ * source distribution.
+ *
+ * This file is part of REDHAWK Basic Components TuneFilterDecimate.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this
+ * program.  If not, see http://www.gnu.org/licenses/.
+ */
+#ifndef FUSEDTFDKERNEL_H
+#define FUSEDTFDKERNEL_H
+
+#include <vector>
+
+#include "DataTypes.h"
+#include "FirDotProduct.h"
+#include "InputSamples.h"
+#include "Mixer.h"
+
+/**************************************************************************
+
+    Single pass tune, filter and decimate.
+
+    The regular chain moves every sample through several full packet sized
+    buffers (conversion, tuner output, filter output, decimator output,
+    interleaved output).  This kernel reads the interleaved input floats
+    directly, mixes one cache sized block at a time into a small working
+    buffer that also holds the filter history, and evaluates only the
+    retained outputs of the lowpass filter (see PolyphaseDecimator),
+    writing them as interleaved floats.  The only full rate memory traffic
+    left is the read of the input itself.
+
+    The mixing is done by the same Mixer the other engines are fed from,
+    one block at a time.
+
+ **************************************************************************/
+class FusedTfdKernel
+{
+public:
+	FusedTfdKernel(const RealVector& taps, size_t decimation, double tuningNorm, size_t blockSize=4096);
+
+	// Process the input samples, appending the retained outputs to output
+	void run(const InputSamples& input, ComplexVector& output);
+
+	void retune(double tuningNorm) { mixer.retune(tuningNorm); }
+
+	// Clear the filter history, decimation phase and mixer phase
+	void reset();
+
+	// Mixer phase in cycles, so a replacement kernel can continue where this one left off
+	double getPhase() const { return mixer.getPhase(); }
+	void setPhase(double cycles) { mixer.setPhase(cycles); }
+
+	// Start the mixer at sample n of the stream, see Mixer::seek
+	void seek(uint64_t n) { mixer.seek(n); }
+
+	size_t getNumTaps() const { return dot.size(); }
+	size_t getDecimation() const { return decimation; }
+
+	// Bytes read from the input and written to the output per input sample so far
+	double getBytesPerSample() const;
+
+private:
+	FirDotProduct dot;
+	size_t decimation;
+	size_t blockSize;
+	size_t nextOutput;      // index in the next block of the next retained output
+	Mixer mixer;
+	ComplexVector work;     // numTaps-1 samples of history followed by one mixed block
+
+	double bytesRead;
+	double bytesWritten;
+	double samplesProcessed;
+};
+
+#endif
@@ -0,0 +1,124 @@
+/*
+ * This file is protected by Copyright. Please refer to the COPYRIGHT file distributed with this
+ * source distribution.
+ *
+ * This file is part of REDHAWK Basic Components TuneFilterDecimate.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this
+ * program.  If not, see http://www.gnu.org/licenses/.
+ */
+#ifndef INPUTPACKET_H
+#define INPUTPACKET_H
+
+#include <string>
+#include <bulkio/bulkio.h>
+
+#include "InputSamples.h"
+
+/**************************************************************************
+
+    A packet from any of the input ports.
+
+    The fields of the port's dataTransfer are reached through references
+    of the same names, so the processing code does not care which port
+    a packet came from; only the samples are reached through samples().
+    Deleting an InputPacket deletes the dataTransfer.
+
+    Packets read through the bulkio stream API carry the same fields in
+    a StreamTransfer, whose dataBuffer is the data block's own shared
+    buffer, so those samples are not copied either.
+
+ **************************************************************************/
+class InputPacket
+{
+public:
+	virtual ~InputPacket() {}
+
+	// numSamples complex or real samples, depending on the mode of the stream
+	InputSamples samples(bool complexInput) const
+	{
+		return InputSamples(format, data, complexInput ? size/2 : size, complexInput); // size will never be odd (or it shouldn't be)
+	}
+
+	BULKIO::PrecisionUTCTime &T;
+	bool &EOS;
+	std::string &streamID;
+	BULKIO::StreamSRI &SRI;
+	bool &sriChanged;
+	bool &inputQueueFlushed;
+
+protected:
+	template <typename TRANSFER>
+	InputPacket(TRANSFER &packet, InputSamples::Format format) :
+		T(packet.T),
+		EOS(packet.EOS),
+		streamID(packet.streamID),
+		SRI(packet.SRI),
+		sriChanged(packet.sriChanged),
+		inputQueueFlushed(packet.inputQueueFlushed),
+		format(format),
+		data(packet.dataBuffer.empty() ? NULL : &packet.dataBuffer[0]),
+		size(packet.dataBuffer.size())
+	{
+	}
+
+private:
+	InputSamples::Format format;
+	const void* data;
+	size_t size; // scalars in the packet
+
+	InputPacket(const InputPacket&);
+	InputPacket& operator= (const InputPacket&);
+};
+
+// The fields of a dataTransfer for a data block read from one of the bulkio input streams
+template <typename SCALAR>
+struct StreamTransfer
+{
+	StreamTransfer() :
+		EOS(false),
+		sriChanged(false),
+		inputQueueFlushed(false)
+	{
+	}
+
+	BULKIO::PrecisionUTCTime T;
+	bool EOS;
+	std::string streamID;
+	BULKIO::StreamSRI SRI;
+	bool sriChanged;
+	bool inputQueueFlushed;
+	redhawk::shared_buffer<SCALAR> dataBuffer;
+};
+
+// Takes ownership of a port's dataTransfer, or of a StreamTransfer
+template <typename TRANSFER>
+class PortPacket : public InputPacket
+{
+public:
+	typedef TRANSFER TransferType;
+
+	PortPacket(TransferType *packet, InputSamples::Format format) :
+		InputPacket(*packet, format),
+		packet(packet)
+	{
+	}
+
+	~PortPacket()
+	{
+		delete packet;
+	}
+
+private:
+	TransferType *packet;
+};
+
+#endif
@@ -0,0 +1,131 @@
+/*
+ * This file is protected by Copyright. Please refer to the COPYRIGHT file distributed with this
+ * source distribution.
+ *
+ * This file is part of REDHAWK Basic Components TuneFilterDecimate.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this
+ * program.  If not, see http://www.gnu.org/licenses/.
+ */
+#ifndef INPUTSAMPLES_H
+#define INPUTSAMPLES_H
+
+#include <algorithm>
+#include <cstddef>
+
+#include "DataTypes.h"
+
+/**************************************************************************
+
+    The samples of one input packet, left in the format of the port they
+    arrived on: interleaved I/Q or real floats, 16-bit or 8-bit integers.
+
+    The engines convert integer samples to float as they read them, a
+    block at a time into a buffer that stays in cache, so integer input
+    costs no conversion pass of its own and crosses the wire and the
+    memory bus at its native size.  Integers are scaled so that full
+    scale is 1.0; octets are taken as signed 8-bit values.
+
+ **************************************************************************/
+struct InputSamples
+{
+	enum Format { FLOAT, SHORT, OCTET };
+
+	InputSamples() :
+		format(FLOAT),
+		data(NULL),
+		numSamples(0),
+		complexInput(true)
+	{
+	}
+
+	InputSamples(const float* data, size_t numSamples, bool complexInput) :
+		format(FLOAT),
+		data(data),
+		numSamples(numSamples),
+		complexInput(complexInput)
+	{
+	}
+
+	InputSamples(Format format, const void* data, size_t numSamples, bool complexInput) :
+		format(format),
+		data(data),
+		numSamples(numSamples),
+		complexInput(complexInput)
+	{
+	}
+
+	size_t scalarsPerSample() const { return complexInput ? 2 : 1; }
+
+	size_t bytesPerScalar() const
+	{
+		switch (format) {
+		case SHORT: return sizeof(short);
+		case OCTET: return sizeof(unsigned char);
+		default:    return sizeof(float);
+		}
+	}
+
+	// count samples starting at sample start
+	InputSamples slice(size_t start, size_t count) const
+	{
+		const char* bytes = static_cast<const char*>(data) + start*scalarsPerSample()*bytesPerScalar();
+		return InputSamples(format, bytes, count, complexInput);
+	}
+
+	// Interleaved I/Q floats when complexInput, else real floats
+	void toFloat(float* out) const
+	{
+		const size_t len = numSamples*scalarsPerSample();
+		switch (format) {
+		case SHORT:
+			convert(static_cast<const short*>(data), len, 1.0f/32768.0f, out);
+			break;
+		case OCTET:
+			convert(static_cast<const signed char*>(data), len, 1.0f/128.0f, out);
+			break;
+		default:
+			std::copy(static_cast<const float*>(data), static_cast<const float*>(data) + len, out);
+		}
+	}
+
+	// Real input gets a zero imaginary part
+	void toComplex(Complex* out) const
+	{
+		if (complexInput) {
+			toFloat(reinterpret_cast<float*>(out));
+			return;
+		}
+		float block[256];
+		for (size_t done=0; done < numSamples; ) {
+			const size_t count = std::min(numSamples-done, sizeof(block)/sizeof(block[0]));
+			slice(done, count).toFloat(block);
+			for (size_t i=0; i < count; i++)
+				out[done+i] = Complex(block[i], 0);
+			done += count;
+		}
+	}
+
+	Format format;
+	const void* data;
+	size_t numSamples;
+	bool complexInput;
+
+private:
+	template <typename T>
+	static void convert(const T* in, size_t len, float scale, float* out)
+	{
+		for (size_t i=0; i < len; i++)
+			out[i] = in[i]*scale;
+	}
+};
+
+#endif
@@ -0,0 +1,143 @@
+/*
+ * This file is protected by Copyright. Please refer to the COPYRIGHT file distributed with this
+ * source distribution.
+ *
+ * This file is part of REDHAWK Basic Components TuneFilterDecimate.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this
+ * program.  If not, see http://www.gnu.org/licenses/.
+ */
+#include "MappedCapture.h"
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+	// Fields of the fixed BLUE header, and of the type 1000 adjunct header that follows it
+	const size_t BLUE_HEADER_SIZE = 512;
+	const size_t BLUE_DATA_REP = 8;
+	const size_t BLUE_DATA_START = 32;
+	const size_t BLUE_DATA_SIZE = 40;
+	const size_t BLUE_FORMAT = 52;
+	const size_t BLUE_XDELTA = 264;
+
+	double readDouble(const char *header, size_t offset)
+	{
+		double value;
+		memcpy(&value, header+offset, sizeof(value));
+		return value;
+	}
+}
+
+MappedCapture::MappedCapture() :
+	fd(-1),
+	map(MAP_FAILED),
+	mapLength(0),
+	data(NULL),
+	numSamples(0),
+	format(InputSamples::FLOAT),
+	complexInput(true),
+	sampleRate(0.0)
+{
+}
+
+MappedCapture::~MappedCapture()
+{
+	close();
+}
+
+void MappedCapture::close()
+{
+	if (map != MAP_FAILED)
+		munmap(map, mapLength);
+	if (fd >= 0)
+		::close(fd);
+	fd = -1;
+	map = MAP_FAILED;
+	mapLength = 0;
+	data = NULL;
+	numSamples = 0;
+	sampleRate = 0.0;
+}
+
+bool MappedCapture::fail(const std::string &message)
+{
+	error = message;
+	close();
+	return false;
+}
+
+bool MappedCapture::setType(const std::string &type)
+{
+	if ((type.size() != 2) || ((type[0] != 'C') && (type[0] != 'S')))
+		return false;
+	complexInput = (type[0] == 'C');
+	switch (type[1]) {
+	case 'F': format = InputSamples::FLOAT; break;
+	case 'I': format = InputSamples::SHORT; break;
+	case 'B': format = InputSamples::OCTET; break;
+	default:  return false;
+	}
+	return true;
+}
+
+bool MappedCapture::open(const std::string &filename, const std::string &type)
+{
+	close();
+	error.clear();
+
+	fd = ::open(filename.c_str(), O_RDONLY);
+	struct stat info;
+	if ((fd < 0) || (fstat(fd, &info) != 0))
+		return fail(filename + ": " + strerror(errno));
+	mapLength = info.st_size;
+	if (mapLength == 0)
+		return fail(filename + ": empty file");
+	map = mmap(NULL, mapLength, PROT_READ, MAP_SHARED, fd, 0);
+	if (map == MAP_FAILED)
+		return fail(filename + ": " + strerror(errno));
+
+	// Every chunk is read front to back, once
+	madvise(map, mapLength, MADV_SEQUENTIAL);
+
+	const char *bytes = static_cast<const char*>(map);
+	size_t dataStart = 0;
+	size_t dataSize = mapLength;
+	if ((mapLength >= BLUE_HEADER_SIZE) && !memcmp(bytes, "BLUE", 4)) {
+		if (memcmp(bytes+BLUE_DATA_REP, "EEEI", 4))
+			return fail(filename + ": only little-endian (EEEI) BLUE data is supported");
+		if (!setType(std::string(bytes+BLUE_FORMAT, 2)))
+			return fail(filename + ": unsupported BLUE format " + std::string(bytes+BLUE_FORMAT, 2));
+		dataStart = size_t(readDouble(bytes, BLUE_DATA_START));
+		dataSize = size_t(readDouble(bytes, BLUE_DATA_SIZE));
+		if ((dataStart > mapLength) || (dataSize > mapLength - dataStart))
+			dataSize = (dataStart > mapLength) ? 0 : mapLength - dataStart; // still being written
+		const double xdelta = readDouble(bytes, BLUE_XDELTA);
+		if (xdelta > 0)
+			sampleRate = 1.0/xdelta;
+	} else if (!setType(type)) {
+		return fail("unsupported data type " + type + ", expected one of CF, CI, CB, SF, SI, SB");
+	}
+
+	data = bytes + dataStart;
+	const InputSamples all(format, data, 0, complexInput);
+	numSamples = dataSize/(all.scalarsPerSample()*all.bytesPerScalar());
+	return true;
+}
+
+InputSamples MappedCapture::samples(size_t start, size_t count) const
+{
+	return InputSamples(format, data, numSamples, complexInput).slice(start, count);
+}
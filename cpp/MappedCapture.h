@@ -0,0 +1,84 @@
+/*
+ * This file is protected by Copyright. Please refer to the COPYRIGHT file distributed with this
+ * source distribution.
+ *
+ * This file is part of REDHAWK Basic Components TuneFilterDecimate.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this
+ * program.  If not, see http://www.gnu.org/licenses/.
+ */
+#ifndef MAPPEDCAPTURE_H
+#define MAPPEDCAPTURE_H
+
+#include <string>
+
+#include "InputSamples.h"
+
+/**************************************************************************
+
+    A capture file mapped into memory, read as InputSamples in place.
+
+    The data type is given the way BLUE files give it: C or S for
+    complex or scalar (real) samples, then F, I or B for 32-bit floats,
+    16-bit or 8-bit integers, e.g. "CF" or "SI".  Raw files hold nothing
+    but the samples, in the machine's byte order.  BLUE files are
+    recognized by their header, which gives the type, the offset and
+    size of the data and the sample interval; only little-endian
+    ("EEEI") data of the types above can be read.
+
+    The mapping is read-only and shared, so any number of threads can
+    read different parts of it, and the kernel pages the file in and out
+    as they do.
+
+ **************************************************************************/
+class MappedCapture
+{
+public:
+	MappedCapture();
+	~MappedCapture();
+
+	// Map a file of the given type (ignored for BLUE files); returns false with
+	// getError() set if it cannot be read
+	bool open(const std::string &filename, const std::string &type="CF");
+	void close();
+
+	const std::string& getError() const { return error; }
+
+	// count samples starting at sample start
+	InputSamples samples(size_t start, size_t count) const;
+
+	size_t getNumSamples() const { return numSamples; }
+	bool isComplex() const { return complexInput; }
+	InputSamples::Format getFormat() const { return format; }
+
+	// From the BLUE header, 0 for raw files
+	double getSampleRate() const { return sampleRate; }
+
+private:
+	bool fail(const std::string &message);
+	bool setType(const std::string &type);
+
+	int fd;
+	void *map;
+	size_t mapLength;
+	const char *data;
+	size_t numSamples;
+	InputSamples::Format format;
+	bool complexInput;
+	double sampleRate;
+	std::string error;
+
+	// Not copyable: owns the mapping
+	MappedCapture(const MappedCapture&);
+	MappedCapture& operator= (const MappedCapture&);
+};
+
+#endif
@@ -0,0 +1,265 @@
+/*
+ * This file is protected by Copyright. Please refer to the COPYRIGHT file distributed with this
+ * source distribution.
+ *
+ * This file is part of REDHAWK Basic Components TuneFilterDecimate.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this
+ * program.  If not, see http://www.gnu.org/licenses/.
+ */
+#include "Mixer.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE__)
+#include <xmmintrin.h>
+#endif
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+
+// AVX kernel compiled for its own target and picked at run time, so the
+// component still runs on CPUs without AVX
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__) && ((__GNUC__ > 4) || ((__GNUC__ == 4) && (__GNUC_MINOR__ >= 9)))
+#define MIXER_HAVE_AVX
+#include <immintrin.h>
+#endif
+
+namespace {
+	const double TWO_POW_64 = 18446744073709551616.0;
+
+	void mixPortable(const float* input, size_t len, bool complexInput, Complex* out,
+			float* rotRe, float* rotIm, float stepRe, float stepIm)
+	{
+		const size_t LANES = 4;
+		for (size_t i=0; i < len; i += LANES) {
+			for (size_t k=0; k < LANES; k++) {
+				const float xRe = complexInput ? input[2*(i+k)] : input[i+k];
+				const float xIm = complexInput ? input[2*(i+k)+1] : 0.0f;
+				out[i+k] = Complex(xRe*rotRe[k] - xIm*rotIm[k], xRe*rotIm[k] + xIm*rotRe[k]);
+				const float tmp = rotRe[k]*stepRe - rotIm[k]*stepIm;
+				rotIm[k] = rotRe[k]*stepIm + rotIm[k]*stepRe;
+				rotRe[k] = tmp;
+			}
+		}
+	}
+
+#if defined(__SSE__)
+	void mixSse(const float* input, size_t len, bool complexInput, Complex* out,
+			float* rotRe, float* rotIm, float stepRe, float stepIm)
+	{
+		__m128 pRe = _mm_loadu_ps(rotRe);
+		__m128 pIm = _mm_loadu_ps(rotIm);
+		const __m128 sRe = _mm_set1_ps(stepRe);
+		const __m128 sIm = _mm_set1_ps(stepIm);
+		float* dst = reinterpret_cast<float*>(out);
+		for (size_t i=0; i < len; i += 4) {
+			__m128 xRe, xIm;
+			if (complexInput) {
+				const __m128 a = _mm_loadu_ps(input + 2*i);
+				const __m128 b = _mm_loadu_ps(input + 2*i + 4);
+				xRe = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2,0,2,0));
+				xIm = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3,1,3,1));
+			} else {
+				xRe = _mm_loadu_ps(input + i);
+				xIm = _mm_setzero_ps();
+			}
+			const __m128 yRe = _mm_sub_ps(_mm_mul_ps(xRe, pRe), _mm_mul_ps(xIm, pIm));
+			const __m128 yIm = _mm_add_ps(_mm_mul_ps(xRe, pIm), _mm_mul_ps(xIm, pRe));
+			_mm_storeu_ps(dst + 2*i, _mm_unpacklo_ps(yRe, yIm));
+			_mm_storeu_ps(dst + 2*i + 4, _mm_unpackhi_ps(yRe, yIm));
+
+			const __m128 tmp = _mm_sub_ps(_mm_mul_ps(pRe, sRe), _mm_mul_ps(pIm, sIm));
+			pIm = _mm_add_ps(_mm_mul_ps(pRe, sIm), _mm_mul_ps(pIm, sRe));
+			pRe = tmp;
+		}
+		_mm_storeu_ps(rotRe, pRe);
+		_mm_storeu_ps(rotIm, pIm);
+	}
+#endif
+
+#if defined(MIXER_HAVE_AVX)
+	__attribute__((target("avx")))
+	void mixAvx(const float* input, size_t len, bool complexInput, Complex* out,
+			float* rotRe, float* rotIm, float stepRe, float stepIm)
+	{
+		__m256 pRe = _mm256_loadu_ps(rotRe);
+		__m256 pIm = _mm256_loadu_ps(rotIm);
+		const __m256 sRe = _mm256_set1_ps(stepRe);
+		const __m256 sIm = _mm256_set1_ps(stepIm);
+		float* dst = reinterpret_cast<float*>(out);
+		for (size_t i=0; i < len; i += 8) {
+			__m256 xRe, xIm;
+			if (complexInput) {
+				// Shuffles stay within 128-bit halves: regroup samples 0-1,4-5 and 2-3,6-7 first
+				const __m256 a = _mm256_loadu_ps(input + 2*i);
+				const __m256 b = _mm256_loadu_ps(input + 2*i + 8);
+				const __m256 lo = _mm256_permute2f128_ps(a, b, 0x20);
+				const __m256 hi = _mm256_permute2f128_ps(a, b, 0x31);
+				xRe = _mm256_shuffle_ps(lo, hi, _MM_SHUFFLE(2,0,2,0));
+				xIm = _mm256_shuffle_ps(lo, hi, _MM_SHUFFLE(3,1,3,1));
+			} else {
+				xRe = _mm256_loadu_ps(input + i);
+				xIm = _mm256_setzero_ps();
+			}
+			const __m256 yRe = _mm256_sub_ps(_mm256_mul_ps(xRe, pRe), _mm256_mul_ps(xIm, pIm));
+			const __m256 yIm = _mm256_add_ps(_mm256_mul_ps(xRe, pIm), _mm256_mul_ps(xIm, pRe));
+			const __m256 lo = _mm256_unpacklo_ps(yRe, yIm);
+			const __m256 hi = _mm256_unpackhi_ps(yRe, yIm);
+			_mm256_storeu_ps(dst + 2*i, _mm256_permute2f128_ps(lo, hi, 0x20));
+			_mm256_storeu_ps(dst + 2*i + 8, _mm256_permute2f128_ps(lo, hi, 0x31));
+
+			const __m256 tmp = _mm256_sub_ps(_mm256_mul_ps(pRe, sRe), _mm256_mul_ps(pIm, sIm));
+			pIm = _mm256_add_ps(_mm256_mul_ps(pRe, sIm), _mm256_mul_ps(pIm, sRe));
+			pRe = tmp;
+		}
+		_mm256_storeu_ps(rotRe, pRe);
+		_mm256_storeu_ps(rotIm, pIm);
+	}
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+	void mixNeon(const float* input, size_t len, bool complexInput, Complex* out,
+			float* rotRe, float* rotIm, float stepRe, float stepIm)
+	{
+		float32x4_t pRe = vld1q_f32(rotRe);
+		float32x4_t pIm = vld1q_f32(rotIm);
+		const float32x4_t sRe = vdupq_n_f32(stepRe);
+		const float32x4_t sIm = vdupq_n_f32(stepIm);
+		float* dst = reinterpret_cast<float*>(out);
+		for (size_t i=0; i < len; i += 4) {
+			float32x4_t xRe, xIm;
+			if (complexInput) {
+				const float32x4x2_t x = vld2q_f32(input + 2*i);
+				xRe = x.val[0];
+				xIm = x.val[1];
+			} else {
+				xRe = vld1q_f32(input + i);
+				xIm = vdupq_n_f32(0.0f);
+			}
+			float32x4x2_t y;
+			y.val[0] = vmlsq_f32(vmulq_f32(xRe, pRe), xIm, pIm);
+			y.val[1] = vmlaq_f32(vmulq_f32(xRe, pIm), xIm, pRe);
+			vst2q_f32(dst + 2*i, y);
+
+			const float32x4_t tmp = vmlsq_f32(vmulq_f32(pRe, sRe), pIm, sIm);
+			pIm = vmlaq_f32(vmulq_f32(pRe, sIm), pIm, sRe);
+			pRe = tmp;
+		}
+		vst1q_f32(rotRe, pRe);
+		vst1q_f32(rotIm, pIm);
+	}
+#endif
+}
+
+const size_t Mixer::BLOCK_SIZE;
+
+uint64_t Mixer::toFixed(double cycles)
+{
+	double fraction = ldexp(cycles - floor(cycles), 64);
+	if (fraction >= TWO_POW_64)
+		return 0;
+	return uint64_t(fraction);
+}
+
+Mixer::Mixer(double tuningNorm) :
+	kernel(&mixPortable),
+	kernelName("portable"),
+	lanes(4),
+	phase(0)
+{
+#if defined(__SSE__)
+	kernel = &mixSse;
+	kernelName = "SSE";
+#endif
+#if defined(MIXER_HAVE_AVX)
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx")) {
+		kernel = &mixAvx;
+		kernelName = "AVX";
+		lanes = 8;
+	}
+#endif
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+	kernel = &mixNeon;
+	kernelName = "NEON";
+#endif
+	retune(tuningNorm);
+}
+
+void Mixer::retune(double tuningNorm)
+{
+	this->tuningNorm = tuningNorm;
+	step = toFixed(tuningNorm);
+	for (size_t k=0; k < lanes; k++) {
+		const double angle = -2.0*M_PI*tuningNorm*k;
+		laneRe[k] = cos(angle);
+		laneIm[k] = sin(angle);
+	}
+	groupRe = cos(-2.0*M_PI*tuningNorm*lanes);
+	groupIm = sin(-2.0*M_PI*tuningNorm*lanes);
+}
+
+double Mixer::getPhase() const
+{
+	return ldexp(double(phase), -64);
+}
+
+void Mixer::setPhase(double cycles)
+{
+	phase = toFixed(cycles);
+}
+
+void Mixer::run(const InputSamples& input, Complex* out)
+{
+	float converted[2*BLOCK_SIZE];
+	for (size_t done = 0; done < input.numSamples; ) {
+		const size_t blockLen = std::min(BLOCK_SIZE, input.numSamples - done);
+		const InputSamples block = input.slice(done, blockLen);
+		if (block.format == InputSamples::FLOAT) {
+			runBlock(static_cast<const float*>(block.data), blockLen, block.complexInput, out + done);
+		} else {
+			// Still in L1 cache when the kernel reads it back
+			block.toFloat(converted);
+			runBlock(converted, blockLen, block.complexInput, out + done);
+		}
+		done += blockLen;
+	}
+}
+
+void Mixer::runBlock(const float* input, size_t len, bool complexInput, Complex* out)
+{
+	// Seed the phasor of every lane from the exact phase: phasor of the first sample times the lane offset
+	const double angle = -2.0*M_PI*ldexp(double(phase), -64);
+	const double seedRe = cos(angle);
+	const double seedIm = sin(angle);
+	float rotRe[MAX_LANES];
+	float rotIm[MAX_LANES];
+	for (size_t k=0; k < lanes; k++) {
+		rotRe[k] = seedRe*laneRe[k] - seedIm*laneIm[k];
+		rotIm[k] = seedRe*laneIm[k] + seedIm*laneRe[k];
+	}
+
+	const size_t vectorLen = len - len%lanes;
+	kernel(input, vectorLen, complexInput, out, rotRe, rotIm, groupRe, groupIm);
+
+	// The lanes now hold the phasors of the samples left over
+	const size_t inc = complexInput ? 2 : 1;
+	for (size_t i=vectorLen, k=0; i < len; i++, k++) {
+		const float xRe = input[inc*i];
+		const float xIm = complexInput ? input[inc*i+1] : 0.0f;
+		out[i] = Complex(xRe*rotRe[k] - xIm*rotIm[k], xRe*rotIm[k] + xIm*rotRe[k]);
+	}
+
+	// Wraps around modulo one cycle
+	phase += uint64_t(len)*step;
+}
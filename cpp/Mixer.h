@@ -0,0 +1,111 @@
+/*
+ * This file is protected by Copyright. Please refer to the COPYRIGHT file distributed with this
+ * source distribution.
+ *
+ * This file is part of REDHAWK Basic Components TuneFilterDecimate.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this
+ * program.  If not, see http://www.gnu.org/licenses/.
+ */
+#ifndef MIXER_H
+#define MIXER_H
+
+#include <stdint.h>
+
+#include "DataTypes.h"
+#include "InputSamples.h"
+
+/**************************************************************************
+
+    Numerically controlled oscillator and complex mixer.
+
+    Reads the packet's interleaved I/Q floats (or real floats) in place,
+    so there is no conversion pass into a complex buffer before tuning:
+    the mix is the first time the data is touched.  Sample n is
+    multiplied by exp(-j*2*pi*tuningNorm*n), n counted from the first
+    sample processed, like the Tuner of the dsp library it replaces.
+
+    The phase is a 64-bit fraction of a cycle that wraps around by
+    itself, so it is exact however long the stream runs.  The phasors are
+    recomputed from it every block of samples, so the rounding errors of
+    the float rotation inside a block never build up into a magnitude or
+    phase drift.
+
+    Within a block, the samples are mixed LANES at a time by a SIMD
+    kernel, each lane rotating its own phasor by LANES samples' worth of
+    phase.  The kernel is picked when the mixer is constructed: AVX on
+    CPUs that have it, SSE on other x86 CPUs, NEON on ARM, and portable
+    code elsewhere.
+
+ **************************************************************************/
+class Mixer
+{
+public:
+	Mixer(double tuningNorm=0.0);
+
+	// Mix the input samples into out; integer samples are converted a block at a time as they are mixed
+	void run(const InputSamples& input, Complex* out);
+
+	// Mix len input samples (interleaved I/Q floats when complexInput, else real floats) into out
+	void run(const float* input, size_t len, bool complexInput, Complex* out)
+	{
+		run(InputSamples(input, len, complexInput), out);
+	}
+
+	void retune(double tuningNorm);
+	double getTuningNorm() const { return tuningNorm; }
+
+	// Phase in cycles of the next input sample, so a replacement can continue where this one left off
+	double getPhase() const;
+	void setPhase(double cycles);
+
+	void reset() { phase = 0; }
+
+	// Phase of sample n of a stream at the current tuning, from the exact 64-bit phase.
+	// A mixer started there on a block boundary (a multiple of BLOCK_SIZE) produces the
+	// same samples, bit for bit, as one that ran through the stream from sample 0 in
+	// packets of multiples of BLOCK_SIZE.
+	void seek(uint64_t n) { phase = n*step; }
+
+	// Name of the SIMD kernel in use
+	const char* getKernelName() const { return kernelName; }
+
+	// Mix len samples, a multiple of lanes, advancing the phasors of the next lanes samples
+	typedef void (*Kernel)(const float* input, size_t len, bool complexInput, Complex* out,
+			float* rotRe, float* rotIm, float stepRe, float stepIm);
+
+	static const size_t MAX_LANES = 8;
+
+	// Samples between recomputations of the phasors from the phase
+	static const size_t BLOCK_SIZE = 256;
+
+	// Fraction of a cycle as a 64-bit phase, in 2^-64 cycles
+	static uint64_t toFixed(double cycles);
+
+private:
+	void runBlock(const float* input, size_t len, bool complexInput, Complex* out);
+
+	Kernel kernel;
+	const char* kernelName;
+	size_t lanes;
+
+	double tuningNorm;
+	uint64_t phase; // at the next input sample, in 2^-64 cycles
+	uint64_t step;  // per sample, in 2^-64 cycles
+
+	// exp(-j*2*pi*tuningNorm*k) for lane k, and the rotation of every lane from one group to the next
+	double laneRe[MAX_LANES];
+	double laneIm[MAX_LANES];
+	float groupRe;
+	float groupIm;
+};
+
+#endif
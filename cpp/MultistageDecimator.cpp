@@ -0,0 +1,202 @@
+/*
+ * This file is protected by Copyright. Please refer to the COPYRIGHT file distributed with this
+ * source distribution.
+ *
+ * This file is part of REDHAWK Basic Components TuneFilterDecimate.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this
+ * program.  If not, see http://www.gnu.org/licenses/.
+ */
+#include "MultistageDecimator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <sstream>
+
+namespace {
+
+// Depth first search over ordered factorizations with a fixed number of stages
+struct PlanSearch
+{
+	double passband;
+	double transitionWidth;
+	double ripple;
+	size_t minTaps;
+	size_t numStages;
+	std::vector<MultistageDecimator::StagePlan> current;
+	std::vector<MultistageDecimator::StagePlan> best;
+	double bestCost;
+
+	void addStage(size_t decimation, double rate, double tw)
+	{
+		MultistageDecimator::StagePlan stage;
+		stage.decimation = decimation;
+		stage.inputRate = rate;
+		stage.transitionWidth = tw;
+		stage.estimatedTaps = MultistageDecimator::estimateTaps(rate, tw, ripple, minTaps);
+		current.push_back(stage);
+	}
+
+	// remaining: decimation still to do, rate: input rate of the next stage,
+	// scale: decimation done so far, costSoFar: flops per original input sample
+	void search(size_t remaining, double rate, double scale, double costSoFar)
+	{
+		if (current.size()+1 == numStages) {
+			// The last stage takes what is left and needs the requested transition width
+			addStage(remaining, rate, transitionWidth);
+			double total = costSoFar + 4.0*current.back().estimatedTaps/(scale*remaining);
+			if (total < bestCost) {
+				bestCost = total;
+				best = current;
+			}
+			current.pop_back();
+			return;
+		}
+
+		std::vector<size_t> factors;
+		for (size_t f=2; f*f <= remaining; f++) {
+			if (remaining % f == 0) {
+				factors.push_back(f);
+				if (f*f != remaining)
+					factors.push_back(remaining/f);
+			}
+		}
+		for (size_t i=0; i < factors.size(); i++) {
+			const size_t f = factors[i];
+			// Aliases only have to be kept out of [0,passband] of the final output
+			double outputRate = rate/f;
+			double tw = outputRate - 2.0*passband;
+			if (tw < transitionWidth)
+				continue;
+			addStage(f, rate, tw);
+			double cost = costSoFar + 4.0*current.back().estimatedTaps/(scale*f);
+			if (cost < bestCost)
+				search(remaining/f, outputRate, scale*f, cost);
+			current.pop_back();
+		}
+	}
+};
+
+}
+
+std::vector<MultistageDecimator::StagePlan> MultistageDecimator::plan(size_t decimation, double inputRate, double passband,
+		double transitionWidth, double ripple, size_t minTaps, size_t maxStages)
+{
+	decimation = std::max(decimation, size_t(1));
+	std::vector<StagePlan> best;
+	double bestCost = std::numeric_limits<double>::max();
+	for (size_t numStages=1; numStages <= std::max(maxStages, size_t(1)); numStages++) {
+		PlanSearch planSearch;
+		planSearch.passband = passband;
+		planSearch.transitionWidth = transitionWidth;
+		planSearch.ripple = ripple/numStages;
+		planSearch.minTaps = minTaps;
+		planSearch.numStages = numStages;
+		planSearch.bestCost = bestCost;
+		planSearch.search(decimation, inputRate, 1.0, 0.0);
+		if (!planSearch.best.empty()) {
+			best = planSearch.best;
+			bestCost = planSearch.bestCost;
+		}
+	}
+	return best;
+}
+
+double MultistageDecimator::cost(const std::vector<StagePlan>& stages)
+{
+	double total = 0.0;
+	double scale = 1.0;
+	for (size_t i=0; i < stages.size(); i++) {
+		scale *= stages[i].decimation;
+		total += 4.0*stages[i].estimatedTaps/scale;
+	}
+	return total;
+}
+
+size_t MultistageDecimator::estimateTaps(double inputRate, double transitionWidth, double ripple, size_t minTaps)
+{
+	if ((transitionWidth <= 0) || (inputRate <= 0) || (ripple <= 0))
+		return minTaps;
+	double A = -20.0*log10(ripple);
+	double dw = 2.0*M_PI*transitionWidth/inputRate;
+	double order = (A > 21.0) ? (A-7.95)/(2.285*dw) : 5.79/dw;
+	return std::max(size_t(ceil(order))+1, minTaps);
+}
+
+std::string MultistageDecimator::describe(const std::vector<size_t>& decimations, const std::vector<size_t>& numTaps)
+{
+	std::ostringstream desc;
+	for (size_t i=0; i < decimations.size(); i++)
+		desc << (i ? "x" : "") << decimations[i];
+	desc << " taps ";
+	for (size_t i=0; i < numTaps.size(); i++)
+		desc << (i ? "," : "") << numTaps[i];
+	return desc.str();
+}
+
+MultistageDecimator::MultistageDecimator(const std::vector<RealVector>& stageTaps, const std::vector<size_t>& decimations)
+{
+	for (size_t i=0; i < stageTaps.size() && i < decimations.size(); i++)
+		stages.push_back(boost::shared_ptr<PolyphaseDecimator>(new PolyphaseDecimator(stageTaps[i], decimations[i])));
+	if (stages.empty())
+		stages.push_back(boost::shared_ptr<PolyphaseDecimator>(new PolyphaseDecimator(RealVector(1, 1.0), 1)));
+	buffers.resize(stages.size()-1);
+}
+
+void MultistageDecimator::run(const Complex* input, size_t len, ComplexVector& output)
+{
+	const Complex* stageInput = input;
+	size_t stageLen = len;
+	for (size_t i=0; i+1 < stages.size(); i++) {
+		buffers[i].clear();
+		if (stageLen != 0)
+			stages[i]->run(stageInput, stageLen, buffers[i]);
+		stageLen = buffers[i].size();
+		stageInput = stageLen ? &buffers[i][0] : NULL;
+	}
+	if (stageLen != 0)
+		stages.back()->run(stageInput, stageLen, output);
+}
+
+void MultistageDecimator::reset()
+{
+	for (size_t i=0; i < stages.size(); i++)
+		stages[i]->reset();
+}
+
+size_t MultistageDecimator::getNumTaps() const
+{
+	size_t total = 0;
+	for (size_t i=0; i < stages.size(); i++)
+		total += stages[i]->getNumTaps();
+	return total;
+}
+
+size_t MultistageDecimator::getHistoryLength() const
+{
+	// Each stage's history is counted in samples of its own input rate
+	size_t total = 1;
+	size_t scale = 1;
+	for (size_t i=0; i < stages.size(); i++) {
+		total += (stages[i]->getNumTaps()-1)*scale;
+		scale *= stages[i]->getDecimation();
+	}
+	return total;
+}
+
+size_t MultistageDecimator::getDecimation() const
+{
+	size_t total = 1;
+	for (size_t i=0; i < stages.size(); i++)
+		total *= stages[i]->getDecimation();
+	return total;
+}
@@ -0,0 +1,90 @@
+/*
+ * This file is protected by Copyright. Please refer to the COPYRIGHT file distributed with this
+ * source distribution.
+ *
+ * This file is part of REDHAWK Basic Components TuneFilterDecimate.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this
+ * program.  If not, see http://www.gnu.org/licenses/.
+ */
+#ifndef MULTISTAGEDECIMATOR_H
+#define MULTISTAGEDECIMATOR_H
+
+#include <string>
+#include <vector>
+#include <boost/shared_ptr.hpp>
+
+#include "DataTypes.h"
+#include "PolyphaseDecimator.h"
+
+/**************************************************************************
+
+    Cascade of polyphase decimating filters.
+
+    A single lowpass designed at the input rate needs a number of taps
+    proportional to InputRate/TransitionWidth, which gets huge for narrow
+    channels out of wideband input.  Splitting the decimation factor into
+    stages M1*M2*...*Mk lets every stage but the last use a very wide
+    transition band: a stage only has to keep out the frequencies that
+    would alias onto the final passband [0,FL], so its stopband starts at
+    (its output rate - FL).  Only the last stage, running at the lowest
+    rate, needs the requested TransitionWidth.
+
+    plan() picks the factorization with the fewest multiply-accumulates
+    per input sample, based on the Kaiser estimate of the taps each stage
+    needs.  The same estimate is used to compare against a single stage.
+
+ **************************************************************************/
+class MultistageDecimator
+{
+public:
+	struct StagePlan
+	{
+		size_t decimation;
+		double inputRate;
+		double transitionWidth; // Hz, at the input rate of the stage
+		size_t estimatedTaps;
+	};
+
+	// Split decimation into at most maxStages factors, minimizing the estimated cost.
+	// passband is the lowpass cutoff (FL) and transitionWidth the one required of the last stage.
+	// Ripple is split evenly between the stages, so each one is designed with ripple/numStages.
+	static std::vector<StagePlan> plan(size_t decimation, double inputRate, double passband, double transitionWidth,
+			double ripple, size_t minTaps, size_t maxStages=4);
+
+	// Flops per input sample of a plan, counted like the other engines (4 per tap per retained output)
+	static double cost(const std::vector<StagePlan>& stages);
+
+	// Kaiser estimate of the taps wdfirHz designs for the given ripple and transition width
+	static size_t estimateTaps(double inputRate, double transitionWidth, double ripple, size_t minTaps);
+
+	// e.g. "8x5x2 taps 29,37,245"
+	static std::string describe(const std::vector<size_t>& decimations, const std::vector<size_t>& numTaps);
+
+	MultistageDecimator(const std::vector<RealVector>& stageTaps, const std::vector<size_t>& decimations);
+
+	// Filter and decimate len complex input samples, appending the outputs of the last stage to output
+	void run(const Complex* input, size_t len, ComplexVector& output);
+
+	// Clear the history and decimation phase of every stage
+	void reset();
+
+	size_t getNumStages() const { return stages.size(); }
+	size_t getNumTaps() const;     // total over all stages
+	size_t getDecimation() const;  // product of the stage factors
+	size_t getHistoryLength() const; // input samples spanned by the impulse response of the cascade
+
+private:
+	std::vector<boost::shared_ptr<PolyphaseDecimator> > stages;
+	std::vector<ComplexVector> buffers; // output of every stage but the last
+};
+
+#endif
@@ -0,0 +1,107 @@
+/*
+ * This file is protected by Copyright. Please refer to the COPYRIGHT file distributed with this
+ * source distribution.
+ *
+ * This file is part of REDHAWK Basic Components TuneFilterDecimate.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this
+ * program.  If not, see http://www.gnu.org/licenses/.
+ */
+#include "OutputBufferPool.h"
+
+OutputBufferPool::OutputBufferPool(size_t maxIdle) :
+	maxIdle(maxIdle),
+	numBuffers(0),
+	numShared(0),
+	numReused(0)
+{
+}
+
+OutputBufferPool::~OutputBufferPool()
+{
+	for (size_t i=0; i < idle.size(); i++)
+		delete idle[i];
+	for (size_t i=0; i < idleShort.size(); i++)
+		delete idleShort[i];
+}
+
+redhawk::shared_buffer<float> OutputBufferPool::share(ComplexVector& buffer)
+{
+	if (buffer.empty())
+		return redhawk::shared_buffer<float>();
+
+	// The samples move to the pooled vector; the caller continues with its empty, recycled storage
+	ComplexVector *storage = acquire(idle);
+	storage->swap(buffer);
+	Releaser<ComplexVector> releaser;
+	releaser.pool = shared_from_this();
+	releaser.buffer = storage;
+	releaser.idle = &idle;
+	return redhawk::shared_buffer<float>(reinterpret_cast<float*>(&(*storage)[0]), 2*storage->size(), releaser);
+}
+
+redhawk::shared_buffer<short> OutputBufferPool::share(std::vector<short>& buffer)
+{
+	if (buffer.empty())
+		return redhawk::shared_buffer<short>();
+
+	std::vector<short> *storage = acquire(idleShort);
+	storage->swap(buffer);
+	Releaser<std::vector<short> > releaser;
+	releaser.pool = shared_from_this();
+	releaser.buffer = storage;
+	releaser.idle = &idleShort;
+	return redhawk::shared_buffer<short>(&(*storage)[0], storage->size(), releaser);
+}
+
+template <typename VECTOR>
+VECTOR* OutputBufferPool::acquire(std::vector<VECTOR*>& idle)
+{
+	{
+		boost::mutex::scoped_lock guard(lock);
+		numShared++;
+		if (!idle.empty()) {
+			VECTOR *storage = idle.back();
+			idle.pop_back();
+			numReused++;
+			return storage;
+		}
+		numBuffers++;
+	}
+	return new VECTOR();
+}
+
+template <typename VECTOR>
+void OutputBufferPool::release(VECTOR *buffer, std::vector<VECTOR*>& idle)
+{
+	buffer->clear();
+	{
+		boost::mutex::scoped_lock guard(lock);
+		if (idle.size() < maxIdle) {
+			idle.push_back(buffer);
+			return;
+		}
+		numBuffers--;
+	}
+	delete buffer;
+}
+
+size_t OutputBufferPool::getNumBuffers() const
+{
+	boost::mutex::scoped_lock guard(lock);
+	return numBuffers;
+}
+
+double OutputBufferPool::getReuseRate() const
+{
+	boost::mutex::scoped_lock guard(lock);
+	return (numShared > 0) ? (numReused/numShared) : 0.0;
+}
@@ -0,0 +1,91 @@
+/*
+ * This file is protected by Copyright. Please refer to the COPYRIGHT file distributed with this
+ * source distribution.
+ *
+ * This file is part of REDHAWK Basic Components TuneFilterDecimate.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this
+ * program.  If not, see http://www.gnu.org/licenses/.
+ */
+#ifndef OUTPUTBUFFERPOOL_H
+#define OUTPUTBUFFERPOOL_H
+
+#include <vector>
+#include <boost/shared_ptr.hpp>
+#include <boost/enable_shared_from_this.hpp>
+#include <boost/thread/mutex.hpp>
+#include <ossie/shared_buffer.h>
+
+#include "DataTypes.h"
+
+/**************************************************************************
+
+    Recycled storage for output packets.
+
+    The engines append their output to a ComplexVector.  share() hands the
+    samples to the output port as a shared buffer of interleaved I/Q floats
+    (std::complex<float> has the layout of two floats) without copying
+    them, and gives the caller a recycled, empty vector in exchange, which
+    keeps the capacity of its earlier use.  When the last consumer of a
+    packet releases it, its vector is cleared and returned to the pool, so
+    in steady state no packet allocates or copies its output.  The 16-bit
+    output is shared the same way from vectors of shorts.
+
+    Consumers may release buffers on any thread and after the component is
+    gone, so the pool must be owned by a boost::shared_ptr; every buffer in
+    flight keeps it alive.
+
+ **************************************************************************/
+class OutputBufferPool : public boost::enable_shared_from_this<OutputBufferPool>
+{
+public:
+	// At most maxIdle buffers are kept for reuse; buffers released beyond that are freed
+	OutputBufferPool(size_t maxIdle=64);
+	~OutputBufferPool();
+
+	// Move the samples of buffer into a shared buffer of interleaved I/Q floats, leaving buffer empty
+	redhawk::shared_buffer<float> share(ComplexVector& buffer);
+	redhawk::shared_buffer<short> share(std::vector<short>& buffer);
+
+	// Buffers allocated by the pool, idle or in flight
+	size_t getNumBuffers() const;
+	// Fraction of share() calls that got a recycled buffer in exchange
+	double getReuseRate() const;
+
+private:
+	template <typename VECTOR>
+	struct Releaser
+	{
+		boost::shared_ptr<OutputBufferPool> pool;
+		VECTOR *buffer;
+		std::vector<VECTOR*> *idle;
+		template <typename T> void operator() (T*) const { pool->release(buffer, *idle); }
+	};
+
+	template <typename VECTOR> VECTOR* acquire(std::vector<VECTOR*>& idle);
+	template <typename VECTOR> void release(VECTOR *buffer, std::vector<VECTOR*>& idle);
+
+	mutable boost::mutex lock;
+	std::vector<ComplexVector*> idle;
+	std::vector<std::vector<short>*> idleShort;
+	size_t maxIdle;
+	size_t numBuffers;
+	double numShared;
+	double numReused;
+
+	// Not copyable: buffers in flight point back to the pool
+	OutputBufferPool(const OutputBufferPool&);
+	OutputBufferPool& operator= (const OutputBufferPool&);
+};
+
+typedef boost::shared_ptr<OutputBufferPool> OutputBufferPoolPtr;
+
+#endif
@@ -0,0 +1,226 @@
+/*
+ * This file is protected by Copyright. Please refer to the COPYRIGHT file distributed with this
+ * source distribution.
+ *
+ * This file is part of REDHAWK Basic Components TuneFilterDecimate.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this
+ * program.  If not, see http://www.gnu.org/licenses/.
+ */
+#ifndef PACKETPIPELINE_H
+#define PACKETPIPELINE_H
+
+#include <vector>
+#include <pthread.h>
+#include <sched.h>
+
+#include <boost/bind.hpp>
+#include <boost/function.hpp>
+#include <boost/thread.hpp>
+
+#include "SpscRing.h"
+
+/**************************************************************************
+
+    Chain of processing stages run on their own threads.
+
+    Every job goes through all of the stages in order.  The stages are
+    split into contiguous groups, one per thread, and consecutive threads
+    are connected by SpscRings, so while one thread works on a job the
+    next one works on the previous job.  Jobs come back from the last
+    thread to the producer through another ring to be reused, buffers
+    and all.
+
+    Given a list of CPUs, thread i is pinned to CPU i (wrapping around
+    the list), so the stages do not migrate and keep their caches.  With
+    an empty list the threads are left to the scheduler, which is what
+    several pipelines on one machine need unless they are given CPUs
+    that do not overlap.
+
+    A thread with an empty ring spins for a few yields, then blocks on a
+    condition variable of its lane until the thread before it pushes.
+    The pushing side only takes the lane's lock when the thread is
+    actually blocked, so a busy pipeline never touches a lock, and an
+    idle one wakes up as soon as the next job arrives.
+
+    Only one thread may call acquire() and push().  Destroying the
+    pipeline finishes the jobs already pushed before joining the threads.
+
+ **************************************************************************/
+template <typename JOB>
+class PacketPipeline
+{
+public:
+	typedef boost::function<void (JOB*)> Stage;
+
+	// finish is called after the last stage, before the job is recycled; the threads are pinned to cpus
+	PacketPipeline(const std::vector<Stage>& stages, size_t numThreads, Stage finish,
+			const std::vector<int>& cpus=std::vector<int>(), size_t ringSize=64) :
+		finish_(finish),
+		recycled_(ringSize),
+		stopping_(false)
+	{
+		numThreads = std::max(std::min(numThreads, stages.size()), size_t(1));
+		for (size_t i=0; i < numThreads; i++) {
+			Lane* lane = new Lane(ringSize);
+			lane->stages.assign(stages.begin() + (i*stages.size())/numThreads, stages.begin() + ((i+1)*stages.size())/numThreads);
+			lanes_.push_back(lane);
+		}
+		for (size_t i=0; i < lanes_.size(); i++) {
+			lanes_[i]->thread = new boost::thread(boost::bind(&PacketPipeline::run, this, i));
+			if (!cpus.empty())
+				pin(lanes_[i]->thread, cpus[i % cpus.size()]);
+		}
+	}
+
+	~PacketPipeline()
+	{
+		__sync_synchronize();
+		stopping_ = true;
+		wake(lanes_[0]);
+		for (size_t i=0; i < lanes_.size(); i++) {
+			lanes_[i]->thread->join();
+			delete lanes_[i]->thread;
+			delete lanes_[i];
+		}
+		JOB* job;
+		while (recycled_.pop(job))
+			delete job;
+	}
+
+	// A job to fill in: a recycled one when available
+	JOB* acquire()
+	{
+		JOB* job;
+		if (recycled_.pop(job))
+			return job;
+		return new JOB();
+	}
+
+	// Waits while the first stage is busy with a full ring of jobs
+	void push(JOB* job)
+	{
+		pushTo(lanes_[0], job);
+	}
+
+	size_t size() const { return lanes_.size(); }
+
+private:
+	struct Lane
+	{
+		Lane(size_t ringSize) : input(ringSize), thread(NULL), done(false), sleeping(false) {}
+		std::vector<Stage> stages;
+		SpscRing<JOB*> input;
+		boost::thread* thread;
+		volatile bool done; // the thread has exited and will not push anything more
+
+		// The thread blocks on wakeup while its ring is empty, with sleeping set
+		boost::mutex lock;
+		boost::condition_variable wakeup;
+		volatile bool sleeping;
+	};
+
+	bool upstreamDone(size_t index) const
+	{
+		return (index == 0) ? stopping_ : lanes_[index-1]->done;
+	}
+
+	void run(size_t index)
+	{
+		Lane* lane = lanes_[index];
+		unsigned int tries = 0;
+		while (true) {
+			JOB* job;
+			if (!lane->input.pop(job)) {
+				if (!upstreamDone(index)) {
+					if (++tries < SPIN_TRIES)
+						boost::this_thread::yield();
+					else
+						block(index);
+					continue;
+				}
+				// Nothing more is coming; take whatever was pushed before that
+				__sync_synchronize();
+				if (!lane->input.pop(job))
+					break;
+			}
+			tries = 0;
+
+			for (size_t i=0; i < lane->stages.size(); i++)
+				lane->stages[i](job);
+
+			if (index+1 < lanes_.size()) {
+				pushTo(lanes_[index+1], job);
+			} else {
+				finish_(job);
+				if (!recycled_.push(job))
+					delete job;
+			}
+		}
+		__sync_synchronize();
+		lane->done = true;
+		if (index+1 < lanes_.size())
+			wake(lanes_[index+1]);
+	}
+
+	// Block the thread of lane index until its ring has a job or the thread before it is done
+	void block(size_t index)
+	{
+		Lane* lane = lanes_[index];
+		boost::mutex::scoped_lock lock(lane->lock);
+		lane->sleeping = true;
+		__sync_synchronize(); // sleeping is visible before the ring is looked at again
+		if (lane->input.empty() && !upstreamDone(index))
+			lane->wakeup.wait(lock);
+		lane->sleeping = false;
+	}
+
+	// Wake the thread of lane if it is blocked; called after pushing to it or finishing upstream
+	static void wake(Lane* lane)
+	{
+		__sync_synchronize(); // the push is visible before sleeping is looked at
+		if (lane->sleeping) {
+			boost::mutex::scoped_lock lock(lane->lock);
+			lane->wakeup.notify_one();
+		}
+	}
+
+	// A full ring means the next thread is busy, so it is only polled, with short sleeps
+	static void pushTo(Lane* lane, JOB* job)
+	{
+		unsigned int tries = 0;
+		while (!lane->input.push(job)) {
+			if (++tries < SPIN_TRIES)
+				boost::this_thread::yield();
+			else
+				boost::this_thread::sleep(boost::posix_time::microseconds(50));
+		}
+		wake(lane);
+	}
+
+	static const unsigned int SPIN_TRIES = 64;
+
+	// A CPU the process may not run on is refused by the kernel, and the thread stays unpinned
+	static void pin(boost::thread* thread, int cpu)
+	{
+		cpu_set_t set;
+		CPU_ZERO(&set);
+		CPU_SET(cpu, &set);
+		pthread_setaffinity_np(thread->native_handle(), sizeof(set), &set);
+	}
+
+	Stage finish_;
+	std::vector<Lane*> lanes_;
+	SpscRing<JOB*> recycled_; // from the last thread back to the producer
+	volatile bool stopping_;
+};
+
+#endif
@@ -0,0 +1,132 @@
+/*
+ * This file is protected by Copyright. Please refer to the COPYRIGHT file distributed with this
+ * source distribution.
+ *
+ * This file is part of REDHAWK Basic Components TuneFilterDecimate.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this
+ * program.  If not, see http://www.gnu.org/licenses/.
+ */
+#ifndef PACKETWORKERPOOL_H
+#define PACKETWORKERPOOL_H
+
+#include <deque>
+#include <string>
+#include <vector>
+
+#include <boost/bind.hpp>
+#include <boost/function.hpp>
+#include <boost/functional/hash.hpp>
+#include <boost/thread.hpp>
+
+/**************************************************************************
+
+    Fixed pool of threads that process packets keyed by stream ID.
+
+    All packets with the same key are handled by the same thread, in the
+    order they were dispatched, so per-stream state never needs to be
+    shared between threads.  Each thread has a bounded queue; dispatch()
+    blocks when the target queue is full so that a slow worker pushes back
+    on the input port queue instead of growing without limit.
+
+    The pool owns the packets it has been given: they are passed to the
+    handler, then deleted.  Destroying the pool drains the packets already
+    queued before joining the threads.
+
+ **************************************************************************/
+template <typename PACKET>
+class PacketWorkerPool
+{
+public:
+	typedef boost::function<void (PACKET*)> Handler;
+
+	PacketWorkerPool(size_t numThreads, Handler handler, size_t maxQueueDepth=64) :
+		handler_(handler),
+		maxQueueDepth_(maxQueueDepth)
+	{
+		for (size_t i=0; i < numThreads; i++) {
+			Worker* worker = new Worker();
+			workers_.push_back(worker);
+			worker->thread = new boost::thread(boost::bind(&PacketWorkerPool::run, this, worker));
+		}
+	}
+
+	~PacketWorkerPool()
+	{
+		for (size_t i=0; i < workers_.size(); i++) {
+			Worker* worker = workers_[i];
+			{
+				boost::mutex::scoped_lock lock(worker->lock);
+				worker->running = false;
+			}
+			worker->notEmpty.notify_all();
+			worker->notFull.notify_all();
+			worker->thread->join();
+			delete worker->thread;
+			for (typename std::deque<PACKET*>::iterator it = worker->queue.begin(); it != worker->queue.end(); ++it)
+				delete *it;
+			delete worker;
+		}
+	}
+
+	void dispatch(const std::string& key, PACKET* packet)
+	{
+		Worker* worker = workers_[boost::hash<std::string>()(key) % workers_.size()];
+		boost::mutex::scoped_lock lock(worker->lock);
+		while (worker->running && (worker->queue.size() >= maxQueueDepth_))
+			worker->notFull.wait(lock);
+		if (!worker->running) {
+			delete packet;
+			return;
+		}
+		worker->queue.push_back(packet);
+		worker->notEmpty.notify_one();
+	}
+
+	size_t size() const { return workers_.size(); }
+
+private:
+	struct Worker
+	{
+		Worker() : running(true), thread(NULL) {}
+		boost::mutex lock;
+		boost::condition_variable notEmpty;
+		boost::condition_variable notFull;
+		std::deque<PACKET*> queue;
+		bool running;
+		boost::thread* thread;
+	};
+
+	void run(Worker* worker)
+	{
+		while (true) {
+			PACKET* packet;
+			{
+				boost::mutex::scoped_lock lock(worker->lock);
+				while (worker->running && worker->queue.empty())
+					worker->notEmpty.wait(lock);
+				if (worker->queue.empty())
+					return; // stopped and drained
+				packet = worker->queue.front();
+				worker->queue.pop_front();
+				worker->notFull.notify_one();
+			}
+			handler_(packet);
+			delete packet;
+		}
+	}
+
+	Handler handler_;
+	size_t maxQueueDepth_;
+	std::vector<Worker*> workers_;
+};
+
+#endif
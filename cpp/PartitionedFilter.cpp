@@ -0,0 +1,120 @@
+/*
+ * This file is protected by Copyright. Please refer to the COPYRIGHT file distributed with this
+ * source distribution.
+ *
+ * This file is part of REDHAWK Basic Components TuneFilterDecimate.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this
+ * program.  If not, see http://www.gnu.org/licenses/.
+ */
+#include "PartitionedFilter.h"
+
+#include <algorithm>
+
+static fftwf_complex* fftw_cast(ComplexFFTWVector& vec)
+{
+	return reinterpret_cast<fftwf_complex*>(&vec[0]);
+}
+
+PartitionedFilter::PartitionedFilter(const RealVector& taps, size_t decimation, size_t blockSize) :
+	numTaps(taps.size()),
+	decimation(std::max(decimation, size_t(1))),
+	blockSize(std::max(blockSize, size_t(1))),
+	nextOutput(0),
+	newest(0)
+{
+	const size_t fftSize = 2*this->blockSize;
+	const size_t numPartitions = std::max((numTaps + this->blockSize - 1)/this->blockSize, size_t(1));
+
+	timeBuffer.resize(fftSize);
+	sum.resize(fftSize);
+	filtered.resize(fftSize);
+	forwardPlan = fftwf_plan_dft_1d(fftSize, fftw_cast(timeBuffer), fftw_cast(sum), FFTW_FORWARD, FFTW_MEASURE);
+	inversePlan = fftwf_plan_dft_1d(fftSize, fftw_cast(sum), fftw_cast(filtered), FFTW_BACKWARD, FFTW_MEASURE);
+
+	// Compute the response of each partition, zero padded to the FFT size.  Planning
+	// may have scribbled on the buffers, so they are only filled in afterwards.
+	responses.resize(numPartitions);
+	const float scale = 1.0/fftSize; // FFTW's inverse transform is unnormalized
+	for (size_t p=0; p < numPartitions; p++) {
+		std::fill(timeBuffer.begin(), timeBuffer.end(), Complex(0,0));
+		const size_t first = p*this->blockSize;
+		const size_t last = std::min(first + this->blockSize, numTaps);
+		for (size_t n=first; n < last; n++)
+			timeBuffer[n-first] = Complex(taps[n], 0);
+		responses[p].resize(fftSize);
+		fftwf_execute_dft(forwardPlan, fftw_cast(timeBuffer), fftw_cast(responses[p]));
+		for (size_t k=0; k < fftSize; k++)
+			responses[p][k] *= scale;
+	}
+
+	delayLine.resize(numPartitions);
+	for (size_t p=0; p < numPartitions; p++)
+		delayLine[p].resize(fftSize);
+	reset();
+}
+
+PartitionedFilter::~PartitionedFilter()
+{
+	fftwf_destroy_plan(forwardPlan);
+	fftwf_destroy_plan(inversePlan);
+}
+
+void PartitionedFilter::reset()
+{
+	std::fill(timeBuffer.begin(), timeBuffer.end(), Complex(0,0));
+	for (size_t p=0; p < delayLine.size(); p++)
+		std::fill(delayLine[p].begin(), delayLine[p].end(), Complex(0,0));
+	blockFill = blockSize;
+	nextOutput = 0;
+	newest = 0;
+}
+
+void PartitionedFilter::run(const Complex* input, size_t len, ComplexVector& output)
+{
+	for (size_t done=0; done < len; ) {
+		const size_t count = std::min(2*blockSize - blockFill, len - done);
+		std::copy(input + done, input + done + count, timeBuffer.begin() + blockFill);
+		blockFill += count;
+		done += count;
+		if (blockFill == 2*blockSize)
+			processBlock(output);
+	}
+}
+
+void PartitionedFilter::processBlock(ComplexVector& output)
+{
+	// The newest block goes into the delay line in place of the oldest one
+	const size_t numPartitions = delayLine.size();
+	newest = (newest + 1) % numPartitions;
+	fftwf_execute_dft(forwardPlan, fftw_cast(timeBuffer), fftw_cast(delayLine[newest]));
+
+	// Partition p of the taps applies to the input block p blocks old
+	const size_t fftSize = 2*blockSize;
+	std::fill(sum.begin(), sum.end(), Complex(0,0));
+	for (size_t p=0; p < numPartitions; p++) {
+		const ComplexFFTWVector& spectrum = delayLine[(newest + numPartitions - p) % numPartitions];
+		const ComplexFFTWVector& response = responses[p];
+		for (size_t k=0; k < fftSize; k++)
+			sum[k] += spectrum[k]*response[k];
+	}
+	fftwf_execute(inversePlan);
+
+	// filtered[blockSize+n] is the output at the n-th sample of the new block
+	size_t n = nextOutput;
+	for (; n < blockSize; n += decimation)
+		output.push_back(filtered[blockSize+n]);
+	nextOutput = n - blockSize;
+
+	// The new block is the previous block of the next one
+	std::copy(timeBuffer.begin()+blockSize, timeBuffer.end(), timeBuffer.begin());
+	blockFill = blockSize;
+}
@@ -0,0 +1,92 @@
+/*
+ * This file is protected by Copyright. Please refer to the COPYRIGHT file distributed with this
+ * source distribution.
+ *
+ * This file is part of REDHAWK Basic Components TuneFilterDecimate.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this
+ * program.  If not, see http://www.gnu.org/licenses/.
+ */
+#ifndef PARTITIONEDFILTER_H
+#define PARTITIONEDFILTER_H
+
+#include <vector>
+#include <fftw3.h>
+
+#include "DataTypes.h"
+#include "firfilter.h"
+
+/**************************************************************************
+
+    Low latency FFT filter and decimator: uniformly partitioned
+    overlap-save convolution.
+
+    The overlap-save filter (firfilter) has to collect fftSize-numTaps+1
+    new samples, with fftSize at least twice the number of taps, before
+    anything comes out.  Here the taps are split into partitions of
+    blockSize, each with its own spectrum of size 2*blockSize.  Every
+    block of blockSize input samples is transformed once and kept in a
+    frequency domain delay line; the output block is the inverse
+    transform of the sum of the last numPartitions input spectra, each
+    multiplied by the response of the partition of the same age.  So an
+    input sample waits at most blockSize samples before its outputs are
+    produced, however long the filter is, at the cost of one spectral
+    multiply per partition for every block.
+
+    The output sequence is the same as filtering every sample and keeping
+    samples 0, M, 2M, ... of the filtered stream, including across calls
+    to run().
+
+    FFTW planning is not thread safe, so partitioned filters must be
+    constructed under the same lock as any other filter.
+
+ **************************************************************************/
+class PartitionedFilter
+{
+public:
+	PartitionedFilter(const RealVector& taps, size_t decimation, size_t blockSize);
+	~PartitionedFilter();
+
+	// Filter and decimate len complex input samples, appending the retained outputs to output
+	void run(const Complex* input, size_t len, ComplexVector& output);
+
+	// Clear the history and the decimation phase; keeps the responses and plans
+	void reset();
+
+	size_t getNumTaps() const { return numTaps; }
+	size_t getBlockSize() const { return blockSize; }
+	size_t getNumPartitions() const { return responses.size(); }
+
+	// Input samples a sample can wait before the outputs it contributes to come out
+	size_t getLatency() const { return blockSize; }
+
+	// Input samples until the output no longer depends on the initial state
+	size_t getHistoryLength() const { return (getNumPartitions()+1)*blockSize; }
+
+private:
+	void processBlock(ComplexVector& output);
+
+	size_t numTaps;
+	size_t decimation;
+	size_t blockSize;
+	size_t blockFill;    // samples in timeBuffer: the previous block, then the new samples so far
+	size_t nextOutput;   // index in the next block of the next retained output
+	size_t newest;       // index in delayLine of the spectrum of the newest block
+	std::vector<ComplexFFTWVector> responses; // spectrum of each partition, scaled by 1/(2*blockSize)
+	std::vector<ComplexFFTWVector> delayLine; // spectra of the last numPartitions input blocks
+	ComplexFFTWVector timeBuffer;
+	ComplexFFTWVector sum;
+	ComplexFFTWVector filtered;
+	fftwf_plan forwardPlan;
+	fftwf_plan inversePlan;
+};
+
+#endif
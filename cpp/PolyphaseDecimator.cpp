@@ -0,0 +1,61 @@
+/*
+ * This file is protected by Copyright. Please refer to the COPYRIGHT file distributed with this
+ * source distribution.
+ *
+ * This file is part of REDHAWK Basic Components TuneFilterDecimate.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this
+ * program.  If not, see http://www.gnu.org/licenses/.
+ */
+#include "PolyphaseDecimator.h"
+
+#include <algorithm>
+
+PolyphaseDecimator::PolyphaseDecimator(const RealVector& taps, size_t decimation) :
+	dot(taps),
+	decimation(std::max(decimation, size_t(1))),
+	phase(0)
+{
+	history.assign(dot.size()-1, Complex(0,0));
+}
+
+void PolyphaseDecimator::reset()
+{
+	std::fill(history.begin(), history.end(), Complex(0,0));
+	phase = 0;
+}
+
+void PolyphaseDecimator::run(const Complex* input, size_t len, ComplexVector& output)
+{
+	const size_t histLen = history.size();
+
+	// Outputs whose window straddles the previous call are computed from a
+	// small staging buffer holding the history followed by the head of the
+	// new input.  Every later output reads the input in place.
+	const size_t headLen = std::min(len, histLen);
+	staging.resize(histLen + headLen);
+	std::copy(history.begin(), history.end(), staging.begin());
+	std::copy(input, input+headLen, staging.begin()+histLen);
+
+	output.reserve(output.size() + (len + decimation - 1)/decimation);
+	size_t n = phase;
+	for (; n < headLen; n += decimation)
+		output.push_back(dot(&staging[n]));
+	for (; n < len; n += decimation)
+		output.push_back(dot(input + n - histLen));
+	phase = n - len;
+
+	// Keep the last histLen input samples for the next call
+	if (len >= histLen)
+		std::copy(input+len-histLen, input+len, history.begin());
+	else
+		std::copy(staging.begin()+len, staging.begin()+len+histLen, history.begin());
+}
@@ -0,0 +1,63 @@
+/*
+ * This file is protected by Copyright. Please refer to the COPYRIGHT file distributed with this
+ * source distribution.
+ *
+ * This file is part of REDHAWK Basic Components TuneFilterDecimate.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this
+ * program.  If not, see http://www.gnu.org/licenses/.
+ */
+#ifndef POLYPHASEDECIMATOR_H
+#define POLYPHASEDECIMATOR_H
+
+#include "DataTypes.h"
+#include "FirDotProduct.h"
+
+/**************************************************************************
+
+    Decimating FIR filter which only evaluates the retained outputs.
+
+    Running an FIR at the full input rate and then discarding
+    DecimationFactor-1 out of every DecimationFactor outputs wastes almost
+    all of the filter work for large decimation factors.  In polyphase form
+    only one phase of the decimated output is ever needed, which reduces to
+    a dot product between the time-reversed prototype filter and the input
+    window ending at each retained sample.  The cost is therefore
+    taps/DecimationFactor multiply-accumulates per input sample.
+
+    The output sequence is identical to filtering every sample and keeping
+    samples 0, M, 2M, ... of the filtered stream (as firfilter + Decimate
+    do), including across calls to run().
+
+ **************************************************************************/
+class PolyphaseDecimator
+{
+public:
+	PolyphaseDecimator(const RealVector& taps, size_t decimation);
+
+	// Filter and decimate len complex input samples, appending the retained outputs to output
+	void run(const Complex* input, size_t len, ComplexVector& output);
+
+	// Clear the filter history and restart the decimation phase
+	void reset();
+
+	size_t getNumTaps() const { return dot.size(); }
+	size_t getDecimation() const { return decimation; }
+
+private:
+	FirDotProduct dot;        // prototype filter, time-reversed so each output is a forward dot product
+	size_t decimation;
+	size_t phase;             // input samples to skip before the next retained output
+	ComplexVector history;    // last numTaps-1 input samples
+	ComplexVector staging;    // history followed by the head of the current input
+};
+
+#endif
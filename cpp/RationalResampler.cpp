@@ -0,0 +1,82 @@
+/*
+ * This file is protected by Copyright. Please refer to the COPYRIGHT file distributed with this
+ * source distribution.
+ *
+ * This file is part of REDHAWK Basic Components TuneFilterDecimate.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this
+ * program.  If not, see http://www.gnu.org/licenses/.
+ */
+#include "RationalResampler.h"
+
+#include <algorithm>
+
+RationalResampler::RationalResampler(const RealVector& taps, size_t interpolation, size_t decimation) :
+	numTaps(taps.size()),
+	interpolation(std::max(interpolation, size_t(1))),
+	decimation(std::max(decimation, size_t(1))),
+	phase(0),
+	next(0)
+{
+	// Every phase gets the same length, the shorter ones padded with zero taps
+	const size_t L = this->interpolation;
+	const size_t phaseLength = std::max((numTaps + L - 1)/L, size_t(1));
+	phases.reserve(L);
+	for (size_t p=0; p < L; p++) {
+		RealVector phaseTaps(phaseLength, 0.0f);
+		for (size_t j=0; (p + j*L) < numTaps; j++)
+			phaseTaps[j] = taps[p + j*L]*Real(L);
+		phases.push_back(FirDotProduct(phaseTaps));
+	}
+	history.assign(phaseLength-1, Complex(0,0));
+}
+
+void RationalResampler::reset()
+{
+	std::fill(history.begin(), history.end(), Complex(0,0));
+	phase = 0;
+	next = 0;
+}
+
+void RationalResampler::run(const Complex* input, size_t len, ComplexVector& output)
+{
+	const size_t histLen = history.size();
+
+	// As in PolyphaseDecimator: the outputs whose window straddles the
+	// previous call read a staging copy, the others the input in place
+	const size_t headLen = std::min(len, histLen);
+	staging.resize(histLen + headLen);
+	std::copy(history.begin(), history.end(), staging.begin());
+	std::copy(input, input+headLen, staging.begin()+histLen);
+
+	// Output k is upsampled sample k*M: input sample n = k*M/L through phase k*M mod L
+	output.reserve(output.size() + (len*interpolation)/decimation + 1);
+	size_t n = next;
+	for (; n < headLen; ) {
+		output.push_back(phases[phase](&staging[n]));
+		phase += decimation;
+		n += phase/interpolation;
+		phase %= interpolation;
+	}
+	for (; n < len; ) {
+		output.push_back(phases[phase](input + n - histLen));
+		phase += decimation;
+		n += phase/interpolation;
+		phase %= interpolation;
+	}
+	next = n - len;
+
+	// Keep the last histLen input samples for the next call
+	if (len >= histLen)
+		std::copy(input+len-histLen, input+len, history.begin());
+	else
+		std::copy(staging.begin()+len, staging.begin()+len+histLen, history.begin());
+}
@@ -0,0 +1,74 @@
+/*
+ * This file is protected by Copyright. Please refer to the COPYRIGHT file distributed with this
+ * source distribution.
+ *
+ * This file is part of REDHAWK Basic Components TuneFilterDecimate.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this
+ * program.  If not, see http://www.gnu.org/licenses/.
+ */
+#ifndef RATIONALRESAMPLER_H
+#define RATIONALRESAMPLER_H
+
+#include <vector>
+
+#include "DataTypes.h"
+#include "FirDotProduct.h"
+
+/**************************************************************************
+
+    Polyphase rational resampler: interpolate by L, lowpass, decimate by M.
+
+    Decimation alone only reaches the output rates InputRate/M.  Upsampling
+    by L first (inserting L-1 zeros after every sample), filtering at
+    L*InputRate and keeping every M-th sample reaches InputRate*L/M, which
+    can be made as close to any rate as wanted.  None of the zeros and
+    none of the dropped samples are ever computed: output k falls on
+    upsampled sample k*M, which only sees the input through every L-th
+    tap of the prototype filter, starting at tap (k*M mod L).  Each output
+    is one dot product with that phase of the filter, so the cost is
+    taps/M multiply-accumulates per input sample, as for the
+    PolyphaseDecimator, which is the L=1 case.
+
+    The prototype is designed at L*InputRate; the zeros scale the signal
+    by 1/L, which the filter makes up for with a gain of L.
+
+ **************************************************************************/
+class RationalResampler
+{
+public:
+	RationalResampler(const RealVector& taps, size_t interpolation, size_t decimation);
+
+	// Resample len complex input samples, appending the outputs to output
+	void run(const Complex* input, size_t len, ComplexVector& output);
+
+	// Clear the filter history and restart at filter phase 0
+	void reset();
+
+	size_t getNumTaps() const { return numTaps; }
+	size_t getInterpolation() const { return interpolation; }
+	size_t getDecimation() const { return decimation; }
+
+	// Input samples each output depends on
+	size_t getHistoryLength() const { return history.size()+1; }
+
+private:
+	std::vector<FirDotProduct> phases; // phase p holds taps p, p+L, p+2L, ... of the prototype
+	size_t numTaps;
+	size_t interpolation;
+	size_t decimation;
+	size_t phase;             // filter phase of the next output, (k*M) mod L
+	size_t next;              // input samples to skip before the next output
+	ComplexVector history;    // last phaseLength-1 input samples
+	ComplexVector staging;    // history followed by the head of the current input
+};
+
+#endif
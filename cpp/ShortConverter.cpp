@@ -0,0 +1,114 @@
+/*
+ * This file is protected by Copyright. Please refer to the COPYRIGHT file distributed with this
+ * source distribution.
+ *
+ * This file is part of REDHAWK Basic Components TuneFilterDecimate.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this
+ * program.  If not, see http://www.gnu.org/licenses/.
+ */
+#include "ShortConverter.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+const float ShortConverter::AGC_TARGET = 16384.0f;
+const double ShortConverter::AGC_RELEASE = 100000.0;
+
+namespace {
+	// The AGC gain is limited so that silence does not turn into full scale noise
+	const float AGC_MIN_PEAK = 1e-6f;
+
+	float peakMagnitude(const float* input, size_t len)
+	{
+		size_t i = 0;
+		float peak = 0.0f;
+#if defined(__SSE2__)
+		const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+		__m128 peaks = _mm_setzero_ps();
+		for (; i+4 <= len; i += 4)
+			peaks = _mm_max_ps(peaks, _mm_and_ps(_mm_loadu_ps(input+i), absMask));
+		float lanes[4];
+		_mm_storeu_ps(lanes, peaks);
+		peak = std::max(std::max(lanes[0], lanes[1]), std::max(lanes[2], lanes[3]));
+#endif
+		for (; i < len; i++)
+			peak = std::max(peak, std::fabs(input[i]));
+		return peak;
+	}
+
+	size_t convert(const float* input, size_t len, float gain, short* out)
+	{
+		size_t i = 0;
+		size_t saturated = 0;
+#if defined(__SSE2__)
+		const __m128 scale = _mm_set1_ps(gain);
+		const __m128 upper = _mm_set1_ps(32767.0f);
+		const __m128 lower = _mm_set1_ps(-32768.0f);
+		for (; i+8 <= len; i += 8) {
+			const __m128 a = _mm_mul_ps(_mm_loadu_ps(input+i), scale);
+			const __m128 b = _mm_mul_ps(_mm_loadu_ps(input+i+4), scale);
+			const int clippedA = _mm_movemask_ps(_mm_or_ps(_mm_cmpgt_ps(a, upper), _mm_cmplt_ps(a, lower)));
+			const int clippedB = _mm_movemask_ps(_mm_or_ps(_mm_cmpgt_ps(b, upper), _mm_cmplt_ps(b, lower)));
+			saturated += __builtin_popcount(clippedA) + __builtin_popcount(clippedB);
+			// Clamp before converting: out of range values would convert to INT_MIN
+			const __m128i intA = _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(a, lower), upper));
+			const __m128i intB = _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(b, lower), upper));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(out+i), _mm_packs_epi32(intA, intB));
+		}
+#endif
+		for (; i < len; i++) {
+			float value = input[i]*gain;
+			if (value > 32767.0f) {
+				value = 32767.0f;
+				saturated++;
+			} else if (value < -32768.0f) {
+				value = -32768.0f;
+				saturated++;
+			}
+			out[i] = short(lrintf(value));
+		}
+		return saturated;
+	}
+}
+
+ShortConverter::ShortConverter() :
+	gain(32767.0f),
+	agc(false),
+	peak(0.0f),
+	appliedGain(32767.0f)
+{
+}
+
+void ShortConverter::configure(float gain, bool agc)
+{
+	this->gain = gain;
+	this->agc = agc;
+}
+
+size_t ShortConverter::run(const float* input, size_t len, std::vector<short>& out)
+{
+	out.resize(len);
+	if (len == 0)
+		return 0;
+
+	appliedGain = gain;
+	if (agc) {
+		peak *= float(exp(-double(len)/AGC_RELEASE));
+		peak = std::max(peak, peakMagnitude(input, len));
+		appliedGain = AGC_TARGET/std::max(peak, AGC_MIN_PEAK);
+	}
+	return convert(input, len, appliedGain, &out[0]);
+}
@@ -0,0 +1,64 @@
+/*
+ * This file is protected by Copyright. Please refer to the COPYRIGHT file distributed with this
+ * source distribution.
+ *
+ * This file is part of REDHAWK Basic Components TuneFilterDecimate.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this
+ * program.  If not, see http://www.gnu.org/licenses/.
+ */
+#ifndef SHORTCONVERTER_H
+#define SHORTCONVERTER_H
+
+#include <cstddef>
+#include <vector>
+
+/**************************************************************************
+
+    Conversion of the float output of one output stream to 16-bit
+    integers for dataShort_out.
+
+    Samples are multiplied by the gain, rounded to the nearest integer
+    and saturated to [-32768, 32767], four or eight values at a time with
+    SSE2 on x86 CPUs.  The number of values that had to be saturated is
+    returned so that clipping can be reported.
+
+    With automatic gain control, the gain puts the peak magnitude of the
+    I and Q values at half of full scale.  The peak follows increases
+    immediately, within the packet being converted, so the output does
+    not clip; after a drop in level it decays with a time constant of
+    AGC_RELEASE values, so the gain does not pump with the signal.
+
+ **************************************************************************/
+class ShortConverter
+{
+public:
+	ShortConverter();
+
+	void configure(float gain, bool agc);
+
+	// Convert len floats into out; returns the number of values saturated
+	size_t run(const float* input, size_t len, std::vector<short>& out);
+
+	// Gain used for the most recent packet
+	float getGain() const { return appliedGain; }
+
+	static const float AGC_TARGET;
+	static const double AGC_RELEASE;
+
+private:
+	float gain;
+	bool agc;
+	float peak;        // decaying maximum of |I| and |Q|, for the AGC
+	float appliedGain;
+};
+
+#endif
@@ -0,0 +1,85 @@
+/*
+ * This file is protected by Copyright. Please refer to the COPYRIGHT file distributed with this
+ * source distribution.
+ *
+ * This file is part of REDHAWK Basic Components TuneFilterDecimate.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this
+ * program.  If not, see http://www.gnu.org/licenses/.
+ */
+#ifndef SPSCRING_H
+#define SPSCRING_H
+
+#include <vector>
+
+/**************************************************************************
+
+    Bounded lock-free ring for exactly one producer and one consumer
+    thread.
+
+    The producer only ever writes tail and the consumer only ever writes
+    head, so neither needs a lock; the full barriers order the slot
+    accesses against the index updates.  They are the GCC __sync
+    builtins, since the Boost versions this component supports predate
+    boost::atomic.  push() and pop() never block; callers decide how to
+    wait.
+
+ **************************************************************************/
+template <typename T>
+class SpscRing
+{
+public:
+	SpscRing(size_t capacity) :
+		slots(capacity+1),
+		head(0),
+		tail(0)
+	{
+	}
+
+	// Producer only: false when the ring is full
+	bool push(const T& item)
+	{
+		const size_t t = tail;
+		const size_t next = (t+1 == slots.size()) ? 0 : t+1;
+		if (next == head)
+			return false;
+		__sync_synchronize(); // the consumer is done with the slot before it is overwritten
+		slots[t] = item;
+		__sync_synchronize(); // the item is visible before the consumer can see the new tail
+		tail = next;
+		return true;
+	}
+
+	// Consumer only: false when the ring is empty
+	bool pop(T& item)
+	{
+		const size_t h = head;
+		if (h == tail)
+			return false;
+		__sync_synchronize(); // read the slot only after seeing the tail that published it
+		item = slots[h];
+		__sync_synchronize(); // done with the slot before the producer can reuse it
+		head = (h+1 == slots.size()) ? 0 : h+1;
+		return true;
+	}
+
+	bool empty() const { return head == tail; }
+
+private:
+	std::vector<T> slots; // one slot always stays free to tell a full ring from an empty one
+	volatile size_t head; // next slot to read
+	volatile size_t tail; // next slot to write
+
+	SpscRing(const SpscRing&);
+	SpscRing& operator= (const SpscRing&);
+};
+
+#endif
@@ -0,0 +1,143 @@
+/*
+ * This file is protected by Copyright. Please refer to the COPYRIGHT file distributed with this
+ * source distribution.
+ *
+ * This file is part of REDHAWK Basic Components TuneFilterDecimate.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this
+ * program.  If not, see http://www.gnu.org/licenses/.
+ */
+#include "StageTelemetry.h"
+
+#include <time.h>
+
+const uint64_t StageTelemetry::WINDOW_NS = 1000000000ULL;
+
+StageTelemetry::StageTelemetry() :
+	enabled(false)
+{
+	reset();
+}
+
+void StageTelemetry::reset()
+{
+	boost::mutex::scoped_lock lock(windowLock);
+	for (size_t i=0; i < NUM_STAGES; i++) {
+		stageNs[i] = 0;
+		windowStageNs[i] = 0;
+		windowNsPerSample[i] = 0.0;
+	}
+	packets = 0;
+	samples = 0;
+	droppedPackets = 0;
+	queueFlushes = 0;
+	rebuilds = 0;
+	for (size_t i=0; i < NUM_SRI_CHANGES; i++)
+		sriChanges[i] = 0;
+	rebuildNs = 0;
+	lastRebuildNs = 0;
+	windowStart = now();
+	windowSamples = 0;
+	__sync_synchronize();
+}
+
+uint64_t StageTelemetry::now()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return uint64_t(ts.tv_sec)*1000000000ULL + ts.tv_nsec;
+}
+
+void StageTelemetry::addTime(Stage stage, uint64_t ns)
+{
+	if (stage == REBUILD) {
+		__sync_fetch_and_add(&rebuilds, 1);
+		__sync_fetch_and_add(&rebuildNs, ns);
+		lastRebuildNs = ns;
+	} else {
+		__sync_fetch_and_add(&stageNs[stage], ns);
+	}
+}
+
+void StageTelemetry::addPacket(size_t numSamples)
+{
+	if (!enabled)
+		return;
+	__sync_fetch_and_add(&packets, 1);
+	__sync_fetch_and_add(&samples, numSamples);
+
+	// Whichever thread gets there first closes the window; the others carry on
+	uint64_t time = now();
+	if (time - windowStart >= WINDOW_NS) {
+		boost::mutex::scoped_try_lock lock(windowLock);
+		if (lock && (time - windowStart >= WINDOW_NS))
+			closeWindow(time);
+	}
+}
+
+void StageTelemetry::addDroppedPacket()
+{
+	if (enabled)
+		__sync_fetch_and_add(&droppedPackets, 1);
+}
+
+void StageTelemetry::addQueueFlush()
+{
+	if (enabled)
+		__sync_fetch_and_add(&queueFlushes, 1);
+}
+
+void StageTelemetry::addSRIChange(SRIChange change)
+{
+	if (enabled)
+		__sync_fetch_and_add(&sriChanges[change], 1);
+}
+
+void StageTelemetry::closeWindow(uint64_t time)
+{
+	// Must be called with windowLock held
+	const uint64_t numSamples = samples - windowSamples;
+	for (size_t i=0; i < NUM_STAGES; i++) {
+		const uint64_t ns = stageNs[i];
+		windowNsPerSample[i] = numSamples ? double(ns - windowStageNs[i])/numSamples : 0.0;
+		windowStageNs[i] = ns;
+	}
+	windowSamples += numSamples;
+	windowStart = time;
+}
+
+telemetry_struct StageTelemetry::getValues()
+{
+	boost::mutex::scoped_lock lock(windowLock);
+	telemetry_struct values;
+	values.Packets = packets;
+	values.Samples = samples;
+	values.DroppedPackets = droppedPackets;
+	values.QueueFlushes = queueFlushes;
+	values.Rebuilds = rebuilds;
+	values.SRIKeywordChanges = sriChanges[SRI_KEYWORDS];
+	values.SRIRFChanges = sriChanges[SRI_RF];
+	values.SRIModeChanges = sriChanges[SRI_MODE];
+	values.SRIRateChanges = sriChanges[SRI_RATE];
+	values.LastRebuildTime = lastRebuildNs*1e-6;
+	values.TotalRebuildTime = rebuildNs*1e-6;
+
+	const double perSample = samples ? 1.0/samples : 0.0;
+	values.PrepareTime = stageNs[PREPARE]*perSample;
+	values.TuneTime = stageNs[TUNE]*perSample;
+	values.FilterTime = stageNs[FILTER]*perSample;
+	values.PushTime = stageNs[PUSH]*perSample;
+	values.PrepareTimeWindow = windowNsPerSample[PREPARE];
+	values.TuneTimeWindow = windowNsPerSample[TUNE];
+	values.FilterTimeWindow = windowNsPerSample[FILTER];
+	values.PushTimeWindow = windowNsPerSample[PUSH];
+	return values;
+}
@@ -0,0 +1,122 @@
+/*
+ * This file is protected by Copyright. Please refer to the COPYRIGHT file distributed with this
+ * source distribution.
+ *
+ * This file is part of REDHAWK Basic Components TuneFilterDecimate.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this
+ * program.  If not, see http://www.gnu.org/licenses/.
+ */
+#ifndef STAGETELEMETRY_H
+#define STAGETELEMETRY_H
+
+#include <stdint.h>
+#include <boost/thread/mutex.hpp>
+
+#include "struct_props.h"
+
+/**************************************************************************
+
+    Time spent in each processing stage, and counts of the events that
+    cost throughput, for the readonly telemetry property.
+
+    The stages are timed with a Timer around each call.  Counters are
+    updated with atomic adds, since the stages of different packets run
+    on different threads in pipelined mode, and the property is built
+    from them only when it is queried.  Besides the totals since the
+    component was started, the time per sample of every stage is kept
+    for the last complete WINDOW_NS window, which the push stage closes.
+
+    While disabled, a Timer is one branch and nothing is counted.
+
+ **************************************************************************/
+class StageTelemetry
+{
+public:
+	// Per sample stages, then filter rebuilds, which are timed per rebuild
+	enum Stage { PREPARE, TUNE, FILTER, PUSH, REBUILD };
+	static const size_t NUM_STAGES = 4;
+
+	// SRI changes of a running stream, by what they cost: a keyword rewrite, a retune of the
+	// tuner (RF or real/complex), or a rebuild of the tuner and filter (sample rate)
+	enum SRIChange { SRI_KEYWORDS, SRI_RF, SRI_MODE, SRI_RATE };
+	static const size_t NUM_SRI_CHANGES = 4;
+
+	// Times the scope it is declared in
+	class Timer
+	{
+	public:
+		Timer(StageTelemetry &telemetry, Stage stage) :
+			telemetry(telemetry),
+			stage(stage),
+			start(telemetry.isEnabled() ? now() : 0)
+		{
+		}
+
+		~Timer()
+		{
+			if (start != 0)
+				telemetry.addTime(stage, now() - start);
+		}
+
+	private:
+		StageTelemetry &telemetry;
+		Stage stage;
+		uint64_t start;
+	};
+
+	StageTelemetry();
+
+	void setEnabled(bool enabled) { this->enabled = enabled; }
+	bool isEnabled() const { return enabled; }
+
+	// Clear every counter; must not race with the data path
+	void reset();
+
+	// Monotonic clock, in nanoseconds
+	static uint64_t now();
+
+	void addTime(Stage stage, uint64_t ns);
+	// Count a packet once it has been pushed
+	void addPacket(size_t numSamples);
+	void addDroppedPacket();
+	void addQueueFlush();
+	void addSRIChange(SRIChange change);
+
+	// Values for the telemetry property
+	telemetry_struct getValues();
+
+	static const uint64_t WINDOW_NS;
+
+private:
+	void closeWindow(uint64_t time);
+
+	volatile bool enabled;
+
+	uint64_t stageNs[NUM_STAGES];
+	uint64_t packets;
+	uint64_t samples;
+	uint64_t droppedPackets;
+	uint64_t queueFlushes;
+	uint64_t rebuilds;
+	uint64_t sriChanges[NUM_SRI_CHANGES];
+	uint64_t rebuildNs;
+	uint64_t lastRebuildNs;
+
+	// The counters at the start of the current window, and the result of the last complete one
+	boost::mutex windowLock;
+	uint64_t windowStart;
+	uint64_t windowStageNs[NUM_STAGES];
+	uint64_t windowSamples;
+	double windowNsPerSample[NUM_STAGES];
+};
+
+#endif
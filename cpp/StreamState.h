@@ -0,0 +1,136 @@
+/*
+ * This file is protected by Copyright. Please refer to the COPYRIGHT file distributed with this
+ * source distribution.
+ *
+ * This file is part of REDHAWK Basic Components TuneFilterDecimate.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this
+ * program.  If not, see http://www.gnu.org/licenses/.
+ */
+#ifndef STREAMSTATE_H
+#define STREAMSTATE_H
+
+#include <string>
+#include <vector>
+#include <boost/shared_ptr.hpp>
+
+#include <bulkio/bulkio.h>
+#include "DataTypes.h"
+#include "Mixer.h"
+#include "FilterChain.h"
+#include "ConfigSnapshot.h"
+#include "ShortConverter.h"
+
+/**************************************************************************
+
+    Processing state for a single input stream.
+
+    Every stream ID gets its own tuner and filter chain along with the
+    buffers they are bound to, so several streams can be processed by the
+    same component without sharing any filter history.  The processing
+    classes keep references to the buffers, so a StreamState must stay at
+    a fixed address for its whole life (the component holds it by pointer).
+
+    When the filter has to be redesigned while the stream is running, the
+    replacement chain is built on another thread and handed over through
+    pendingChain.  The stream then feeds it the same input as the current
+    chain, holding back only its newest outputs, until it has seen a full
+    filter history, and only then switches over, so the output never
+    restarts from an empty filter.  Both chains decimate on the grid of
+    the stream, and the new one picks up at the first output the old one
+    did not produce (see FilterChain::continueFrom), so nothing is
+    repeated or lost at the switch.
+
+    After a queue flush or an EOS the stream only clears its filter
+    history and tuner phase (see resetPending), keeping its taps and FFT
+    plans, so that picking up again costs no redesign.
+
+ **************************************************************************/
+struct StreamState
+{
+	StreamState(const std::string& id) :
+		streamID(id),
+		warmupRemaining(0),
+		rebuildGeneration(0),
+		designPending(false),
+		dispatchRebuild(false),
+		filterSamples(0),
+		inputComplex(true),
+		chan_if(0.0),
+		inputRate(0.0),
+		inputRF(0.0),
+		remakeFilter(false),
+		retune(false),
+		tuningRFChanged(false),
+		sriPending(false),
+		resetPending(false)
+	{
+	}
+
+	bool ready() const
+	{
+		return chain && (tuner || !chain->needsTuner());
+	}
+
+	// Stream ID of the (first) output stream produced from this input stream
+	std::string outputStreamID() const
+	{
+		if (chain && (chain->channelizer != NULL))
+			return streamID + "_ch0";
+		return streamID;
+	}
+
+	std::string streamID;
+
+	// Processing classes.  Packets hold on to them as well, so a replacement can be
+	// installed while an earlier packet is still running through the old ones.
+	boost::shared_ptr<Mixer> tuner;
+	FilterChainPtr chain;        // produces the output
+	FilterChainPtr pendingChain; // built in the background, not started yet
+	FilterChainPtr warmupChain;  // runs alongside chain until it has a full history
+	size_t warmupRemaining;      // input samples warmupChain still has to see
+	unsigned int rebuildGeneration; // bumped on every remake so that stale background builds are dropped
+	FilterDesign nextDesign;     // latest design requested from the background builder
+	bool designPending;          // nextDesign has not been picked up by the builder yet
+	bool dispatchRebuild;        // a job must be queued for the builder once the lock is released
+	FilterChainPtr lastChain;    // chain that ran on the previous packet; only used by the filter stage
+	uint64_t filterSamples;      // input samples the filter stage has run since the start or a reset; ditto
+
+	// Internal buffers
+	firfilter::complexVector f_complexIn; // Tuner output, input to the filter chain
+
+	// Input SRI the stream was last configured from, before configureTFD() made it the output SRI
+	BULKIO::StreamSRI inputSRI;
+	// Output SRI before the per-chain changes (sample rate, channel stream IDs)
+	BULKIO::StreamSRI outputSRI;
+	// Output SRI of every channel in multi-channel mode; only used by the push stage
+	std::vector<BULKIO::StreamSRI> channelSRIs;
+	// Gain state of every output stream on dataShort_out; only used by the push stage
+	std::vector<ShortConverter> shortConverters;
+
+	// Stream parameters taken from the SRI
+	bool inputComplex;
+	double chan_if;
+	double inputRate;
+	double inputRF;
+
+	// Configuration snapshot the stream was last brought up to date with
+	ConfigSnapshotPtr config;
+
+	// Pending work, set from new configuration snapshots
+	bool remakeFilter;    // Used to indicate we must redo the filter
+	bool retune;          // Used to indicate the tuner must pick up a new tuning frequency
+	bool tuningRFChanged; // Used to indicate the CHAN_RF keyword must be updated in the output SRI
+	bool sriPending;      // Used to indicate the output SRIs must go out with the next packet
+	bool resetPending;    // Used to indicate the filter history and tuner phase must be cleared; set under the component lock
+};
+
+#endif
@@ -0,0 +1,66 @@
+/*
+ * This file is protected by Copyright. Please refer to the COPYRIGHT file distributed with this
+ * source distribution.
+ *
+ * This file is part of REDHAWK Basic Components TuneFilterDecimate.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this
+ * program.  If not, see http://www.gnu.org/licenses/.
+ */
+#include "TfdEngine.h"
+
+TfdEngine::TfdEngine(FilterChainBuilder &builder) :
+	builder(builder)
+{
+}
+
+void TfdEngine::configure(const FilterDesign &design)
+{
+	chain.reset();
+	chain = builder.build(design);
+	mixer.retune(design.tuningNorm);
+	mixer.reset();
+}
+
+void TfdEngine::retune(double tuningNorm)
+{
+	mixer.retune(tuningNorm);
+	if (chain)
+		chain->retune(tuningNorm);
+}
+
+void TfdEngine::seek(uint64_t n)
+{
+	mixer.seek(n);
+	if (chain)
+		chain->seek(n);
+}
+
+void TfdEngine::process(const InputSamples &input, std::vector<ComplexVector> &output)
+{
+	if (!chain)
+		return;
+
+	// The fused kernel, the bandpass decimator and the channelizer mix the packet themselves
+	if (chain->needsTuner()) {
+		tuned.resize(input.numSamples);
+		if (input.numSamples != 0)
+			mixer.run(input, &tuned[0]);
+	}
+	chain->run(input, tuned);
+
+	// Trade storage with the caller rather than copying
+	output.resize(chain->output.size());
+	for (size_t i=0; i < output.size(); i++) {
+		output[i].swap(chain->output[i]);
+		chain->output[i].clear();
+	}
+}
@@ -0,0 +1,73 @@
+/*
+ * This file is protected by Copyright. Please refer to the COPYRIGHT file distributed with this
+ * source distribution.
+ *
+ * This file is part of REDHAWK Basic Components TuneFilterDecimate.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this
+ * program.  If not, see http://www.gnu.org/licenses/.
+ */
+#ifndef TFDENGINE_H
+#define TFDENGINE_H
+
+#include <vector>
+#include <stdint.h>
+
+#include "DataTypes.h"
+#include "InputSamples.h"
+#include "Mixer.h"
+#include "FilterChain.h"
+#include "FilterChainBuilder.h"
+
+/**************************************************************************
+
+    Tune, filter and decimate of a single stream, without any of the
+    REDHAWK plumbing around it: the same Mixer and FilterChain the
+    component runs, built by the same FilterChainBuilder, called in turn
+    on the caller's thread.  The component spreads these steps over its
+    processing stages instead (see PacketJob), so that they can run on
+    different threads.
+
+    This is what the benchmark measures, and a convenient target for
+    profiling the DSP without a domain.
+
+ **************************************************************************/
+class TfdEngine
+{
+public:
+	// The builder must outlive the engine
+	explicit TfdEngine(FilterChainBuilder &builder);
+
+	// Build the filter chain for a design and tune to design.tuningNorm; the filter and
+	// mixer start from scratch
+	void configure(const FilterDesign &design);
+
+	void retune(double tuningNorm);
+
+	// Continue the tuner phase from sample n of the stream, for processing it in pieces
+	// (see Mixer::seek); the filter history still starts empty
+	void seek(uint64_t n);
+
+	// Process one packet.  output[i] is replaced with the output of output stream i: just one,
+	// or one per channel in multi-channel mode.
+	void process(const InputSamples &input, std::vector<ComplexVector> &output);
+
+	bool isConfigured() const { return static_cast<bool>(chain); }
+	const FilterChain& getChain() const { return *chain; }
+
+private:
+	FilterChainBuilder &builder;
+	Mixer mixer;
+	FilterChainPtr chain;
+	firfilter::complexVector tuned;
+};
+
+#endif
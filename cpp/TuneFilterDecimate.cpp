@@ -27,19 +27,9 @@
 #include "TuneFilterDecimate.h"
 
 //set allowed bounds here for static members to make the compilers happy
-const size_t TuneFilterDecimate_i::MIN_NUM_TAPS= 25;
-const size_t TuneFilterDecimate_i::MAX_NUM_TAPS= 4*1024*1024;
-const size_t TuneFilterDecimate_i::MIN_FFT_SIZE= 64;
-const size_t TuneFilterDecimate_i::MAX_FFT_SIZE= 8*1024*1024;
-
-//find the power of 2 greater then or equal to the input number
-size_t pow2ge(size_t n)
-{
-	size_t out=2;
-	while (n>out)
-		out*=2;
-	return out;
-};
+const size_t TuneFilterDecimate_i::LATENCY_BINS= 24;
+const size_t TuneFilterDecimate_i::MAX_ENDED_STREAMS= 16;
+const float TuneFilterDecimate_i::WAIT_SLICE= 0.001f;
 
 PREPARE_LOGGING(TuneFilterDecimate_i)
 
@@ -48,66 +38,106 @@ TuneFilterDecimate_base(uuid, label)
 {
 	LOG_TRACE(TuneFilterDecimate_i, "TuneFilterDecimate() constructor entry");
 
-	// Initialize processing classes
-	tuner = NULL;
-	filter = NULL;
-	decimate = NULL;
-
 	// Initialize private variables
+	workerPool = NULL;
+	pipeline = NULL;
+	lastInputPort = 0;
+	useStreamAPI = false;
+	builderPool = NULL;
+	outputPool.reset(new OutputBufferPool());
+	LatencyHistogram.assign(LATENCY_BINS, 0);
 	chan_if = 0;
-	tuningRFChanged = false;
-	RemakeFilter = false;
-	inputComplex = true;
+	configVersion_ = 0;
+	tuningVersion_ = 0;
+	filterVersion_ = 0;
+	configuredFftSize_ = filterProps.FFT_size;
 
 	// Initialize provides port maxQueueDepth
 	dataFloat_in->setMaxQueueDepth(1000);
+	dataShort_in->setMaxQueueDepth(1000);
+	dataOctet_in->setMaxQueueDepth(1000);
 
+	// Weigh the direct and FFT filter forms by how fast they actually run here
+	builder_.calibrate();
+	LOG_DEBUG(TuneFilterDecimate_i, "Filter cost calibration: direct " << builder_.getCostModel().getDirectNsPerFlop()
+			<< " ns/flop, FFT " << builder_.getCostModel().getFftNsPerFlop() << " ns/flop");
+
+	addPropertyChangeListener("TuneMode", this, &TuneFilterDecimate_i::TuneModeChanged);
 	addPropertyChangeListener("TuningNorm", this, &TuneFilterDecimate_i::TuningNormChanged); //configureTuner
 	addPropertyChangeListener("TuningIF", this, &TuneFilterDecimate_i::TuningIFChanged); //configureTuner
 	addPropertyChangeListener("TuningRF", this, &TuneFilterDecimate_i::TuningRFChanged); //configureTuner
 	addPropertyChangeListener("FilterBW", this, &TuneFilterDecimate_i::FilterBWChanged); //configureFilter
 	addPropertyChangeListener("DesiredOutputRate", this, &TuneFilterDecimate_i::DesiredOutputRateChanged); //configureFilter
 	addPropertyChangeListener("filterProps", this, &TuneFilterDecimate_i::filterPropsChanged); //configureFilter
+	addPropertyChangeListener("FilterEngine", this, &TuneFilterDecimate_i::FilterEngineChanged); //configureFilter
+	addPropertyChangeListener("AutoFFTSize", this, &TuneFilterDecimate_i::AutoFFTSizeChanged); //configureFilter
+	addPropertyChangeListener("PartitionSize", this, &TuneFilterDecimate_i::PartitionSizeChanged); //configureFilter
+	addPropertyChangeListener("RationalResampling", this, &TuneFilterDecimate_i::RationalResamplingChanged); //configureFilter
+	addPropertyChangeListener("ResampleTolerance", this, &TuneFilterDecimate_i::ResampleToleranceChanged); //configureFilter
+	addPropertyChangeListener("channels", this, &TuneFilterDecimate_i::channelsChanged); //configureFilter
+	addPropertyChangeListener("DesignCacheSize", this, &TuneFilterDecimate_i::DesignCacheSizeChanged);
+	addPropertyChangeListener("FFTWWisdomFile", this, &TuneFilterDecimate_i::FFTWWisdomFileChanged);
+	addPropertyChangeListener("ShortOutputGain", this, &TuneFilterDecimate_i::ShortOutputGainChanged);
+	addPropertyChangeListener("ShortOutputAGC", this, &TuneFilterDecimate_i::ShortOutputAGCChanged);
+	addPropertyChangeListener("TelemetryEnabled", this, &TuneFilterDecimate_i::TelemetryEnabledChanged);
+	setPropertyQueryImpl(telemetry, this, &TuneFilterDecimate_i::getTelemetry);
+	setPropertyQueryImpl(OutputBuffers, this, &TuneFilterDecimate_i::getOutputBuffers);
+	setPropertyQueryImpl(OutputBufferReuse, this, &TuneFilterDecimate_i::getOutputBufferReuse);
+	telemetry_.setEnabled(TelemetryEnabled);
+
+	boost::mutex::scoped_lock lock(configLock_);
+	publishConfig();
 }
 
 TuneFilterDecimate_i::~TuneFilterDecimate_i()
 {
-	if (tuner)
-		delete tuner;
-	if (filter)
-		delete filter;
-	if (decimate)
-		delete decimate;
+	delete workerPool;
+	delete pipeline;
+	delete builderPool;
+	// Release the filter chains while the planner lock still exists
+	streams.clear();
+}
+
+void TuneFilterDecimate_i::TuneModeChanged(const std::string *oldValue, const std::string *newValue)
+{
+	if (*oldValue != *newValue) {
+		// Streams pick up the new mode the next time they are configured
+		boost::mutex::scoped_lock lock(configLock_);
+		publishConfig();
+	}
 }
 
 void TuneFilterDecimate_i::TuningNormChanged(const double *oldValue, const double *newValue)
 {
 	if (*oldValue != *newValue) {
-		boost::mutex::scoped_lock lock(TuneFilterDecimateLock_);
+		boost::mutex::scoped_lock lock(configLock_);
 		configureTuner("TuningNorm");
+		retuneStreams();
 	}
 }
 
 void TuneFilterDecimate_i::TuningIFChanged(const double *oldValue, const double *newValue)
 {
 	if (*oldValue != *newValue) {
-		boost::mutex::scoped_lock lock(TuneFilterDecimateLock_);
+		boost::mutex::scoped_lock lock(configLock_);
 		configureTuner("TuningIF");
+		retuneStreams();
 	}
 }
 
 void TuneFilterDecimate_i::TuningRFChanged(const CORBA::ULongLong *oldValue, const CORBA::ULongLong *newValue)
 {
 	if (*oldValue != *newValue) {
-		boost::mutex::scoped_lock lock(TuneFilterDecimateLock_);
+		boost::mutex::scoped_lock lock(configLock_);
 		configureTuner("TuningRF");
+		retuneStreams();
 	}
 }
 
 void TuneFilterDecimate_i::FilterBWChanged(const float *oldValue, const float *newValue)
 {
 	if (*oldValue != *newValue) {
-		boost::mutex::scoped_lock lock(TuneFilterDecimateLock_);
+		boost::mutex::scoped_lock lock(configLock_);
 		configureFilter("FilterBW");
 	}
 }
@@ -115,7 +145,7 @@ void TuneFilterDecimate_i::FilterBWChanged(const float *oldValue, const float *n
 void TuneFilterDecimate_i::DesiredOutputRateChanged(const float *oldValue, const float *newValue)
 {
 	if (*oldValue != *newValue) {
-		boost::mutex::scoped_lock lock(TuneFilterDecimateLock_);
+		boost::mutex::scoped_lock lock(configLock_);
 		configureFilter("DesiredOutputRate");
 	}
 }
@@ -123,10 +153,12 @@ void TuneFilterDecimate_i::DesiredOutputRateChanged(const float *oldValue, const
 void TuneFilterDecimate_i::filterPropsChanged(const filterProps_struct *oldValue, const filterProps_struct *newValue)
 {
 	bool changed = false;
-	boost::mutex::scoped_lock lock(TuneFilterDecimateLock_);
+	boost::mutex::scoped_lock lock(configLock_);
 
-	if (oldValue->FFT_size != newValue->FFT_size) {
+	// filterProps.FFT_size reads back the size in use, so it is compared with the size last configured
+	if ((oldValue->FFT_size != newValue->FFT_size) || (newValue->FFT_size != configuredFftSize_)) {
 		filterProps.FFT_size = newValue->FFT_size;
+		configuredFftSize_ = newValue->FFT_size;
 		changed = true;
 	}
 
@@ -145,9 +177,194 @@ void TuneFilterDecimate_i::filterPropsChanged(const filterProps_struct *oldValue
 	}
 }
 
+void TuneFilterDecimate_i::FilterEngineChanged(const std::string *oldValue, const std::string *newValue)
+{
+	if (*oldValue != *newValue) {
+		boost::mutex::scoped_lock lock(configLock_);
+		configureFilter("FilterEngine");
+	}
+}
+
+void TuneFilterDecimate_i::AutoFFTSizeChanged(const bool *oldValue, const bool *newValue)
+{
+	if (*oldValue != *newValue) {
+		boost::mutex::scoped_lock lock(configLock_);
+		configureFilter("AutoFFTSize");
+	}
+}
+
+void TuneFilterDecimate_i::PartitionSizeChanged(const CORBA::ULong *oldValue, const CORBA::ULong *newValue)
+{
+	if (*oldValue != *newValue) {
+		boost::mutex::scoped_lock lock(configLock_);
+		configureFilter("PartitionSize");
+	}
+}
+
+void TuneFilterDecimate_i::RationalResamplingChanged(const bool *oldValue, const bool *newValue)
+{
+	if (*oldValue != *newValue) {
+		boost::mutex::scoped_lock lock(configLock_);
+		configureFilter("RationalResampling");
+	}
+}
+
+void TuneFilterDecimate_i::ResampleToleranceChanged(const double *oldValue, const double *newValue)
+{
+	if (*oldValue != *newValue) {
+		boost::mutex::scoped_lock lock(configLock_);
+		configureFilter("ResampleTolerance");
+	}
+}
+
+void TuneFilterDecimate_i::channelsChanged(const std::vector<channel_struct> *oldValue, const std::vector<channel_struct> *newValue)
+{
+	if (*oldValue != *newValue) {
+		boost::mutex::scoped_lock lock(configLock_);
+		configureFilter("channels");
+	}
+}
+
+void TuneFilterDecimate_i::ShortOutputGainChanged(const float *oldValue, const float *newValue)
+{
+	// Only the push stage uses it, from the snapshot of every packet
+	boost::mutex::scoped_lock lock(configLock_);
+	publishConfig();
+}
+
+void TuneFilterDecimate_i::ShortOutputAGCChanged(const bool *oldValue, const bool *newValue)
+{
+	boost::mutex::scoped_lock lock(configLock_);
+	publishConfig();
+}
+
+void TuneFilterDecimate_i::TelemetryEnabledChanged(const bool *oldValue, const bool *newValue)
+{
+	// The data path checks it once per stage; counting resumes from where it stopped
+	telemetry_.setEnabled(*newValue);
+}
+
+void TuneFilterDecimate_i::DesignCacheSizeChanged(const CORBA::ULong *oldValue, const CORBA::ULong *newValue)
+{
+	builder_.setCacheCapacity(*newValue);
+}
+
+void TuneFilterDecimate_i::FFTWWisdomFileChanged(const std::string *oldValue, const std::string *newValue)
+{
+	if (*oldValue != *newValue) {
+		boost::mutex::scoped_lock lock(configLock_);
+		loadWisdom();
+	}
+}
+
+void TuneFilterDecimate_i::loadWisdom() {
+	if (FFTWWisdomFile.empty())
+		return;
+	if (builder_.importWisdom(FFTWWisdomFile)) {
+		LOG_DEBUG(TuneFilterDecimate_i, "Imported FFTW wisdom from " << FFTWWisdomFile);
+	} else {
+		LOG_DEBUG(TuneFilterDecimate_i, "No FFTW wisdom imported from " << FFTWWisdomFile);
+	}
+	// The FFT size timings are only worth as much as the wisdom they were measured with
+	if (builder_.loadFftTimings(FFTWWisdomFile + ".fftsizes"))
+		LOG_DEBUG(TuneFilterDecimate_i, "Loaded FFT size timings from " << FFTWWisdomFile << ".fftsizes");
+}
+
+void TuneFilterDecimate_i::saveWisdom() {
+	if (FFTWWisdomFile.empty())
+		return;
+	if (!builder_.exportWisdom(FFTWWisdomFile))
+		LOG_WARN(TuneFilterDecimate_i, "Could not export FFTW wisdom to " << FFTWWisdomFile);
+	if (!builder_.saveFftTimings(FFTWWisdomFile + ".fftsizes"))
+		LOG_WARN(TuneFilterDecimate_i, "Could not save FFT size timings to " << FFTWWisdomFile << ".fftsizes");
+}
+
+void TuneFilterDecimate_i::updateCacheCounters() {
+	size_t hits, misses;
+	builder_.getCacheCounters(hits, misses);
+	boost::mutex::scoped_lock lock(configLock_);
+	DesignCacheHits = hits;
+	DesignCacheMisses = misses;
+}
+
 void TuneFilterDecimate_i::configureFilter(const std::string &propid) {
 	LOG_DEBUG(TuneFilterDecimate_i, "Triggering filter remake");
-	RemakeFilter = true;
+	remakeFilters();
+}
+
+void TuneFilterDecimate_i::remakeFilters() {
+	filterVersion_++;
+	publishConfig();
+}
+
+void TuneFilterDecimate_i::retuneStreams() {
+	tuningVersion_++;
+	publishConfig();
+}
+
+void TuneFilterDecimate_i::publishConfig() {
+	boost::shared_ptr<ConfigSnapshot> config(new ConfigSnapshot());
+	config->version = ++configVersion_;
+	config->tuningVersion = tuningVersion_;
+	config->filterVersion = filterVersion_;
+	config->TuneMode = TuneMode;
+	config->TuningNorm = TuningNorm;
+	config->TuningIF = TuningIF;
+	config->TuningRF = TuningRF;
+	config->FilterBW = FilterBW;
+	config->DesiredOutputRate = DesiredOutputRate;
+	config->RationalResampling = RationalResampling;
+	config->ResampleTolerance = ResampleTolerance;
+	config->filterProps = filterProps;
+	config->filterProps.FFT_size = configuredFftSize_;
+	config->AutoFFTSize = AutoFFTSize;
+	config->FilterEngine = FilterEngine;
+	config->PartitionSize = PartitionSize;
+	config->channels = channels;
+	config->ShortOutputGain = ShortOutputGain;
+	config->ShortOutputAGC = ShortOutputAGC;
+	boost::atomic_store(&config_, ConfigSnapshotPtr(config));
+}
+
+void TuneFilterDecimate_i::applyConfig(StreamState &stream, const ConfigSnapshotPtr &config) {
+	if (stream.config == config)
+		return;
+	if (stream.config) {
+		if ((config->tuningVersion != stream.config->tuningVersion) && stream.tuner) {
+			stream.retune = true;
+			stream.tuningRFChanged = true;
+		}
+		if (config->filterVersion != stream.config->filterVersion)
+			stream.remakeFilter = true;
+	}
+	stream.config = config;
+}
+
+double TuneFilterDecimate_i::streamTuningNorm(const StreamState &stream, const ConfigSnapshot &config) {
+	// The tuning properties are shared by all streams, but IF and RF tuning
+	// map to a different normalized frequency for each sample rate and RF
+	if (config.TuneMode == "IF") {
+		return (stream.inputRate > 0) ? (config.TuningIF / stream.inputRate) : 0.0;
+	} else if (config.TuneMode == "RF") {
+		return (stream.inputRate > 0) ? ((config.TuningRF + stream.chan_if - stream.inputRF) / stream.inputRate) : 0.0;
+	}
+	return config.TuningNorm;
+}
+
+size_t TuneFilterDecimate_i::warmupLength(const StreamState &stream) {
+	size_t length = stream.warmupChain->historyLength() + stream.warmupChain->gridPeriod();
+	if (stream.chain)
+		length += stream.chain->latency();
+	return length;
+}
+
+double TuneFilterDecimate_i::streamChannelRF(const StreamState &stream, const ConfigSnapshot &config) {
+	if (config.TuneMode == "RF")
+		return config.TuningRF;
+	double tuningIF = (config.TuneMode == "IF") ? config.TuningIF : stream.inputRate * config.TuningNorm;
+	// Integer Hz, to match the TuningRF readback
+	CORBA::ULongLong channelRF = stream.inputRF + tuningIF - stream.chan_if;
+	return channelRF;
 }
 
 void TuneFilterDecimate_i::configureTuner(const std::string &propid) {
@@ -194,191 +411,691 @@ void TuneFilterDecimate_i::configureTuner(const std::string &propid) {
 			<< " Norm: " << TuningNorm
 			<< " IF: " << TuningIF
 			<< " RF: " << TuningRF);
-
-	if (tuner != NULL) {
-		LOG_DEBUG(TuneFilterDecimate_i, "Retuning Tuner");
-		tuner->retune(TuningNorm);
-		tuningRFChanged = true;
-	} else {
-		LOG_DEBUG(TuneFilterDecimate_i, "Skipping tuner configuration because SRI hasn't been received");
-	}
 }
 
 void TuneFilterDecimate_i::start() throw (CORBA::SystemException, CF::Resource::StartError) {
 	if (this->started()) { return; }
 
-	// Process the SRI and create an initial filter if one is not already created
-	if ((*(dataFloat_in->activeSRIs())).length() > 0 ){
-		if ((*(dataFloat_in->activeSRIs())).length() > 1 ) {
-			LOG_WARN(TuneFilterDecimate_i, "Input has more than one active SRI, using first one");
+	{
+		boost::mutex::scoped_lock lock(configLock_);
+		loadWisdom();
+		publishConfig(); // properties may have been initialized without a change listener firing
+	}
+	useStreamAPI = UseStreamAPI;
+	std::fill(LatencyHistogram.begin(), LatencyHistogram.end(), 0);
+	ShortOutputSaturations = 0;
+	telemetry_.reset();
+
+	// Process the SRIs and create an initial filter for each stream that is already active
+	ConfigSnapshotPtr config = boost::atomic_load(&config_);
+	BULKIO::StreamSRISequence *portSRIs[] = { dataFloat_in->activeSRIs(), dataShort_in->activeSRIs(), dataOctet_in->activeSRIs() };
+	for (size_t port=0; port < 3; port++) {
+		BULKIO::StreamSRISequence *activeSRIs = portSRIs[port];
+		for (unsigned int i=0; i < activeSRIs->length(); i++) {
+			BULKIO::StreamSRI sri = (*activeSRIs)[i];
+			StreamStatePtr stream;
+			{
+				boost::mutex::scoped_lock lock(TuneFilterDecimateLock_);
+				stream = getStream(std::string(sri.streamID));
+			}
+			applyConfig(*stream, config);
+			configureTFD(sri, stream, *config);
 		}
-		configureTFD((*(dataFloat_in->activeSRIs()))[0]);
+		delete activeSRIs;
+	}
+
+	// Filters of running streams are redesigned on their own thread
+	builderPool = new PacketWorkerPool<RebuildJob>(1, boost::bind(&TuneFilterDecimate_i::rebuildChain, this, _1));
+
+	if (PipelineThreads > 0) {
+		// The service thread prepares every packet; the stages after it are spread over the pipeline threads
+		std::vector<PacketPipeline<PacketJob>::Stage> stages;
+		stages.push_back(boost::bind(&TuneFilterDecimate_i::tuneStage, this, _1));
+		stages.push_back(boost::bind(&TuneFilterDecimate_i::filterStage, this, _1));
+		stages.push_back(boost::bind(&TuneFilterDecimate_i::pushStage, this, _1));
+		if (WorkerThreads > 0)
+			LOG_WARN(TuneFilterDecimate_i, "WorkerThreads is ignored when PipelineThreads is set");
+		pipeline = new PacketPipeline<PacketJob>(stages, PipelineThreads, boost::bind(&TuneFilterDecimate_i::finishJob, this, _1),
+				parseCpuList(PipelineCPUs));
+		LOG_DEBUG(TuneFilterDecimate_i, "Processing streams with a pipeline of " << pipeline->size() << " threads");
+	} else if (WorkerThreads > 0) {
+		LOG_DEBUG(TuneFilterDecimate_i, "Processing streams with " << WorkerThreads << " worker threads");
+		workerPool = new PacketWorkerPool<PacketType>(WorkerThreads, boost::bind(&TuneFilterDecimate_i::processPacket, this, _1));
 	}
 
 	// Call Base Class Start which will start serviceFunction thread
 	TuneFilterDecimate_base::start();
 }
 
+void TuneFilterDecimate_i::stop() throw (CORBA::SystemException, CF::Resource::StopError) {
+	TuneFilterDecimate_base::stop();
+
+	// Finish the packets already handed to the workers or the pipeline
+	delete workerPool;
+	workerPool = NULL;
+	delete pipeline;
+	pipeline = NULL;
+
+	// Nothing can queue a rebuild anymore; the builder takes the lock to hand over its result, so join it without holding the lock
+	delete builderPool;
+	builderPool = NULL;
+
+	boost::mutex::scoped_lock lock(configLock_);
+	saveWisdom();
+}
+
+std::vector<int> TuneFilterDecimate_i::parseCpuList(const std::string& list) {
+	// Comma separated CPU numbers and first-last ranges, as taken by taskset -c
+	std::vector<int> cpus;
+	size_t pos = 0;
+	while (pos < list.size()) {
+		size_t end = list.find(',', pos);
+		if (end == std::string::npos)
+			end = list.size();
+		const std::string item = list.substr(pos, end-pos);
+		pos = end+1;
+		if (item.find_first_not_of(' ') == std::string::npos)
+			continue;
+		char *next;
+		const long first = strtol(item.c_str(), &next, 10);
+		long last = first;
+		if (*next == '-')
+			last = strtol(next+1, &next, 10);
+		while (*next == ' ')
+			next++;
+		if ((*next != '\0') || (first < 0) || (last < first) || (last >= CPU_SETSIZE)) {
+			LOG_WARN(TuneFilterDecimate_i, "Ignoring '" << item << "' in PipelineCPUs");
+			continue;
+		}
+		for (long cpu=first; cpu <= last; cpu++)
+			cpus.push_back(int(cpu));
+	}
+	return cpus;
+}
+
+TuneFilterDecimate_i::StreamStatePtr TuneFilterDecimate_i::getStream(const std::string& id) {
+	StreamMap::iterator it = streams.find(id);
+	if (it == streams.end()) {
+		LOG_DEBUG(TuneFilterDecimate_i, "New stream: '" << id << "'");
+		it = streams.insert(std::make_pair(id, StreamStatePtr(new StreamState(id)))).first;
+	} else {
+		// A stream that ended is picked up again by the next one with its ID
+		std::deque<std::string>::iterator ended = std::find(endedStreams.begin(), endedStreams.end(), id);
+		if (ended != endedStreams.end())
+			endedStreams.erase(ended);
+	}
+	return it->second;
+}
+
+void TuneFilterDecimate_i::endStream(const std::string& id) {
+	if (std::find(endedStreams.begin(), endedStreams.end(), id) == endedStreams.end())
+		endedStreams.push_back(id);
+	while (endedStreams.size() > MAX_ENDED_STREAMS) {
+		streams.erase(endedStreams.front());
+		endedStreams.pop_front();
+	}
+}
+
+template <typename PORT>
+TuneFilterDecimate_i::PacketType* TuneFilterDecimate_i::getPortPacket(PORT *port, InputSamples::Format format, float timeout) {
+	typename PORT::dataTransfer *packet = port->getPacket(timeout);
+	if (packet == NULL)
+		return NULL;
+	return new PortPacket<typename PORT::dataTransfer>(packet, format);
+}
+
+template <typename PORT>
+TuneFilterDecimate_i::PacketType* TuneFilterDecimate_i::getStreamPacket(PORT *port, InputSamples::Format format, float timeout) {
+	typename PORT::StreamType stream = port->getCurrentStream(timeout);
+	if (!stream)
+		return NULL;
+
+	// One packet's worth of data, or nothing when the stream ended without any left
+	typename PORT::StreamType::DataBlockType block = stream.tryread();
+	if (!block) {
+		if (!stream.eos())
+			return NULL;
+		StreamTransfer<float> *packet = new StreamTransfer<float>();
+		packet->T = bulkio::time::utils::notSet();
+		packet->EOS = true;
+		packet->streamID = stream.streamID();
+		packet->SRI = stream.sri();
+		return new PortPacket<StreamTransfer<float> >(packet, format);
+	}
+	return newStreamPacket(stream, block, block.buffer(), format);
+}
+
+template <typename STREAM, typename BLOCK, typename SCALAR>
+TuneFilterDecimate_i::PacketType* TuneFilterDecimate_i::newStreamPacket(STREAM &stream, const BLOCK &block,
+		const redhawk::shared_buffer<SCALAR> &buffer, InputSamples::Format format) {
+	// The packet shares the block's buffer, which keeps the samples alive until it is deleted
+	StreamTransfer<SCALAR> *packet = new StreamTransfer<SCALAR>();
+	packet->T = block.getStartTime();
+	packet->EOS = stream.eos();
+	packet->streamID = stream.streamID();
+	packet->SRI = block.sri();
+	packet->sriChanged = block.sriChanged();
+	packet->inputQueueFlushed = block.inputQueueFlushed();
+	packet->dataBuffer = buffer;
+	return new PortPacket<StreamTransfer<SCALAR> >(packet, format);
+}
+
+TuneFilterDecimate_i::PacketType* TuneFilterDecimate_i::getPacket(size_t port, float timeout) {
+	if (useStreamAPI) {
+		if (port == 0)
+			return getStreamPacket(dataFloat_in, InputSamples::FLOAT, timeout);
+		else if (port == 1)
+			return getStreamPacket(dataShort_in, InputSamples::SHORT, timeout);
+		return getStreamPacket(dataOctet_in, InputSamples::OCTET, timeout);
+	}
+	if (port == 0)
+		return getPortPacket(dataFloat_in, InputSamples::FLOAT, timeout);
+	else if (port == 1)
+		return getPortPacket(dataShort_in, InputSamples::SHORT, timeout);
+	return getPortPacket(dataOctet_in, InputSamples::OCTET, timeout);
+}
+
+TuneFilterDecimate_i::PacketType* TuneFilterDecimate_i::getPacket(float timeout) {
+	// Poll every port, starting after the one that delivered last so that none of them starves
+	for (size_t i=1; i <= 3; i++) {
+		const size_t port = (lastInputPort + i) % 3;
+		PacketType *pkt = getPacket(port, 0.0);
+		if (pkt != NULL) {
+			lastInputPort = port;
+			return pkt;
+		}
+	}
+	if (timeout <= 0)
+		return NULL;
+
+	// Only one queue can be waited on at a time, so wait on each in turn for a short slice,
+	// starting with the one that delivered last; a packet on any port waits at most a round
+	for (size_t i=0; timeout > 0; i++) {
+		const size_t port = (lastInputPort + i) % 3;
+		const float slice = std::min(timeout, WAIT_SLICE);
+		timeout -= slice;
+		PacketType *pkt = getPacket(port, slice);
+		if (pkt != NULL) {
+			lastInputPort = port;
+			return pkt;
+		}
+	}
+	return NULL;
+}
+
 int TuneFilterDecimate_i::serviceFunction() {
-	bulkio::InFloatPort::dataTransfer *pkt = dataFloat_in->getPacket(0.0); // non-blocking
-	if(pkt == NULL) return NOOP;
+	// Wait on the queue, or poll it and let the service thread sleep when it is empty
+	float timeout = std::max(PacketTimeout, 0.0f);
+	PacketType *pkt = getPacket(timeout);
+	if(pkt == NULL) return (timeout > 0) ? NORMAL : NOOP;
 
 	if(pkt->inputQueueFlushed)
 	{
 		LOG_WARN(TuneFilterDecimate_i, "Input queue has been flushed.  Data has been lost");
-		RemakeFilter = true; // flush filter
+		telemetry_.addQueueFlush();
+		// Packets from every stream may have been lost: start them over from an empty filter
+		// history on their next packet, without redesigning anything
+		boost::mutex::scoped_lock lock(TuneFilterDecimateLock_);
+		for (StreamMap::iterator it = streams.begin(); it != streams.end(); ++it)
+			it->second->resetPending = true;
 	}
-	if (streamID!=pkt->streamID)
+
+	if (pipeline != NULL) {
+		PacketJob *job = pipeline->acquire();
+		job->pkt = pkt;
+		preparePacket(job);
+		pipeline->push(job); // finishJob() deletes the packet once it is pushed
+	} else if (workerPool != NULL) {
+		workerPool->dispatch(pkt->streamID, pkt); // the pool deletes the packet once it is processed
+	} else {
+		processPacket(pkt);
+		delete pkt; // Must delete the dataTransfer object when no longer needed
+	}
+
+	return NORMAL;
+}
+
+void TuneFilterDecimate_i::PacketJob::clear() {
+	pkt = NULL;
+	stream.reset();
+	config.reset();
+	tuner.reset();
+	chain.reset();
+	warmupChain.reset();
+	retune = false;
+	inheritPhase = false;
+	startWarmup = false;
+	resetState = false;
+	pushSRIs = false;
+	tuned.clear();
+	output.clear(); // returns the output buffers to the pool once the port is done with them
+}
+
+void TuneFilterDecimate_i::processPacket(PacketType *pkt) {
+	PacketJob job;
+	job.pkt = pkt;
+	preparePacket(&job);
+
+	// Run the stages in turn; the tuner output buffer stays with the stream between packets
+	job.tuned.swap(job.stream->f_complexIn);
+	tuneStage(&job);
+	filterStage(&job);
+	pushStage(&job);
+	job.tuned.swap(job.stream->f_complexIn);
+}
+
+void TuneFilterDecimate_i::preparePacket(PacketJob *job) {
+	StageTelemetry::Timer timer(telemetry_, StageTelemetry::PREPARE);
+	PacketType *pkt = job->pkt;
+
+	// Latest configuration; property changes publish a new snapshot instead of waiting for the data path
+	ConfigSnapshotPtr config = boost::atomic_load(&config_);
+
+	StreamStatePtr stream;
+	FilterChainPtr builtChain;
+	unsigned int generation;
+	bool resetState;
 	{
-		if (streamID=="")
-			streamID=pkt->streamID;
-		else
-		{
-			LOG_WARN(TuneFilterDecimate_i, "Dropping data from unknown stream ID.  Expected "
-					<< streamID << " received " << pkt->streamID);
-			delete pkt; //must delete the dataTransfer object when no longer needed
-			return NORMAL;
-		}
+		boost::mutex::scoped_lock lock(TuneFilterDecimateLock_);
+		stream = getStream(pkt->streamID);
+		builtChain.swap(stream->pendingChain);
+		generation = stream->rebuildGeneration;
+		resetState = stream->resetPending;
+		stream->resetPending = false;
 	}
+	job->stream = stream;
+	job->config = config;
+
+	// The stream is only ever prepared by this thread, so the rest runs without holding the lock
+	applyConfig(*stream, config);
 
 	// Check if SRI has been changed
-	if(pkt->sriChanged || RemakeFilter || tuningRFChanged || (dataFloat_out->getCurrentSRI().count(pkt->streamID)==0)) {
-		LOG_DEBUG(TuneFilterDecimate_i, "Reconfiguring TFD");
-		configureTFD(pkt->SRI); // Process and/or update the SRI
-		dataFloat_out->pushSRI(pkt->SRI); // Push the new SRI to the next component
-		tuningRFChanged = false;
+	bool sriChanged = false;
+	if(pkt->sriChanged || stream->remakeFilter || stream->tuningRFChanged || (dataFloat_out->getCurrentSRI().count(stream->outputStreamID())==0)) {
+		// Only as much is redone as the change requires; a stream that is not running yet is configured in full
+		const BULKIO::StreamSRI inputSRI = pkt->SRI;
+		StageTelemetry::SRIChange change = StageTelemetry::SRI_RATE;
+		if (pkt->sriChanged && stream->ready()) {
+			change = classifySRIChange(inputSRI, *stream);
+			telemetry_.addSRIChange(change);
+		}
+
+		if ((change == StageTelemetry::SRI_KEYWORDS) && !stream->remakeFilter && !stream->tuningRFChanged) {
+			LOG_DEBUG(TuneFilterDecimate_i, "Updating SRI keywords for stream: '" << pkt->streamID << "'");
+			updateSRIKeywords(pkt->SRI, *stream, *config);
+		} else {
+			LOG_DEBUG(TuneFilterDecimate_i, "Reconfiguring TFD for stream: '" << pkt->streamID << "'");
+			const FilterChainPtr previousChain = stream->chain;
+			const double previousRate = stream->inputRate;
+			configureTFD(pkt->SRI, stream, *config); // Process and/or update the SRI
+			stream->tuningRFChanged = false;
+			if (generation != stream->rebuildGeneration)
+				builtChain.reset(); // superseded by the filter requested just now
+			// The fused kernel and the bandpass decimator own the mixer, so a chain rebuilt for the same sample rate carries on with its phase
+			job->inheritPhase = previousChain && (stream->chain != previousChain) && (stream->inputRate == previousRate);
+		}
+		stream->inputSRI = inputSRI;
+		sriChanged = true;
 	}
 
-	if ((tuner == NULL) || (filter == NULL) || (decimate == NULL)) {
-		LOG_TRACE(TuneFilterDecimate_i, "TFD cannot complete work, dropping data");
-		delete pkt;
-		return NOOP;
+	if (builtChain) {
+		// A replacement designed in the background: run it alongside the current chain until its history is full
+		stream->warmupChain = builtChain;
+		stream->warmupRemaining = warmupLength(*stream);
+		job->startWarmup = true;
+		stream->retune = true; // the tuning may have changed while it was being built
+		publishChain(*stream->warmupChain);
+		LOG_DEBUG(TuneFilterDecimate_i, "Warming up new filter for stream: '" << pkt->streamID << "' over " << stream->warmupRemaining << " samples");
 	}
 
-	size_t iInc; // Increment to parse packet into tunerInput
-	size_t buffLen_0; // Length of initial buffer
-	if(inputComplex) {
-		iInc = 2;
-		buffLen_0 = pkt->dataBuffer.size()/2; // pkt->dataBuffer.size() will never be odd (or it shouldn't be)
+	if (resetState) {
+		// Only the history is cleared; the taps, plans and tuning of the stream stay as they are
+		LOG_DEBUG(TuneFilterDecimate_i, "Resetting filter state for stream: '" << pkt->streamID << "'");
+		if (stream->warmupChain)
+			stream->warmupRemaining = warmupLength(*stream);
 	}
-	else {
-		iInc = 1;
-		buffLen_0 = pkt->dataBuffer.size();
+
+	if (stream->dispatchRebuild && (builderPool != NULL)) {
+		RebuildJob *rebuildJob = new RebuildJob();
+		rebuildJob->stream = stream;
+		builderPool->dispatch(stream->streamID, rebuildJob); // the pool deletes the job once it is processed
 	}
-	//std::cout<<"input data size = "<<  buffLen_0<<std::endl;
+	stream->dispatchRebuild = false;
+
+	if (stream->ready()) {
+		job->inputComplex = stream->inputComplex;
+		job->tuner = stream->tuner;
+		job->chain = stream->chain;
+		job->warmupChain = stream->warmupChain;
+		job->resetState = resetState;
 
-	tunerInput.resize(buffLen_0);
-	f_complexIn.resize(buffLen_0);
+		if (stream->retune) {
+			LOG_DEBUG(TuneFilterDecimate_i, "Retuning Tuner for stream: '" << pkt->streamID << "'");
+			job->retune = true;
+			job->tuningNorm = streamTuningNorm(*stream, *config);
+			stream->retune = false;
+		}
 
-	// Process dataBuffer vector
-	int inputIndex = 0;
-	for(size_t i=0; i < pkt->dataBuffer.size(); i+=iInc) { // dataBuffer must be even (and should be for complex data)
-		if(inputComplex)
-			// Convert to the tunerInput complex data type
-			tunerInput[inputIndex++] = Complex(pkt->dataBuffer[i], pkt->dataBuffer[i+1]);
-		else
-			tunerInput[inputIndex++] = Complex(pkt->dataBuffer[i], 0);
+		if (sriChanged || stream->sriPending) {
+			// Push the new SRI to the next component, ahead of the data
+			job->pushSRIs = true;
+			job->outputSRI = stream->outputSRI;
+			job->inputRate = stream->inputRate;
+			job->inputRF = stream->inputRF;
+			job->chan_if = stream->chan_if;
+			stream->sriPending = false;
+		}
+
+		if (stream->warmupChain) {
+			size_t numSamples = pkt->samples(stream->inputComplex).numSamples;
+			stream->warmupRemaining -= std::min(stream->warmupRemaining, numSamples);
+			if (stream->warmupRemaining == 0) {
+				// This packet still comes out of the old chain; the next one comes out of the new one
+				LOG_DEBUG(TuneFilterDecimate_i, "Switching to new filter for stream: '" << pkt->streamID << "'");
+				stream->chain = stream->warmupChain;
+				stream->warmupChain.reset();
+				stream->sriPending = true;
+			}
+		}
+	} else {
+		LOG_TRACE(TuneFilterDecimate_i, "TFD cannot complete work, dropping data");
+		telemetry_.addDroppedPacket();
 	}
 
-	bool packetPushed(false);
-	{
+	if (pkt->EOS) {
+		// There is a desire that the tuner Phase gets reset to 0 on EOS
+		// The next packet with this ID resets the stream state rather than building it from scratch
 		boost::mutex::scoped_lock lock(TuneFilterDecimateLock_);
+		stream->resetPending = true;
+		endStream(pkt->streamID);
+	}
+}
 
-		// Run Tuner: fills up f_<type>In vector
-		tuner->run();
+void TuneFilterDecimate_i::tuneStage(PacketJob *job) {
+	StageTelemetry::Timer timer(telemetry_, StageTelemetry::TUNE);
+	if (!job->chain)
+		return;
+	if (job->resetState && job->tuner)
+		job->tuner->reset();
+	if (job->retune && job->tuner)
+		job->tuner->retune(job->tuningNorm);
 
-		// Run Filter: fills up f_<type>Out vector
-		filter->newComplexData(f_complexIn); // Tuner always outputs complex data in current implementation.
+	// The fused kernel, the bandpass decimator and the channelizer mix the packet themselves; the other engines read the tuner output
+	if (job->chain->needsTuner() || (job->warmupChain && job->warmupChain->needsTuner())) {
+		InputSamples input = job->pkt->samples(job->inputComplex);
+		// Run Tuner straight from the packet's samples, converting integers as it goes: fills up the tuned vector
+		job->tuned.resize(input.numSamples);
+		if (input.numSamples != 0)
+			job->tuner->run(input, &job->tuned[0]);
+	}
+}
 
-		size_t buffLen_1 = f_complexOut.size(); // Size the rest of the buffers according to the filtered data.
-		if (buffLen_1 !=0)
-		{
-			//std::cout<<"buffLen_1 = "<< buffLen_1<<std::endl;
-			decimateOutput.reserve((buffLen_1+DecimationFactor-1)/DecimationFactor);
-			// Run Decimation: fills up decimateOutput vector
-			decimate->run();
-			size_t decOutputSize(decimateOutput.size());
-			if (decOutputSize !=0)
-			{
-				//std::cout<<"decOutputSize = "<< decOutputSize<<std::endl;
-				floatBuffer.reserve(2*decimateOutput.size());
-				// Buffer is full, so place the data into the floatBuffer
-				for(size_t j=0; j< decimateOutput.size(); j++) {
-					floatBuffer.push_back(decimateOutput[j].real());
-					floatBuffer.push_back(decimateOutput[j].imag());
-				}
-				decimateOutput.clear();
-				// Push the data to the next component
-				dataFloat_out->pushPacket(floatBuffer, pkt->T, pkt->EOS, pkt->streamID);
-				floatBuffer.clear();
+void TuneFilterDecimate_i::filterStage(PacketJob *job) {
+	StageTelemetry::Timer timer(telemetry_, StageTelemetry::FILTER);
+	if (!job->chain)
+		return;
+	StreamState &stream = *job->stream;
+	FilterChain &chain = *job->chain;
+
+	// Mixer phase hand-overs between the chains that tune themselves, in the order the packets run through them
+	if (job->inheritPhase && chain.tunesInput() && stream.lastChain && stream.lastChain->tunesInput())
+		chain.setPhase(stream.lastChain->getPhase());
+	if (job->startWarmup && job->warmupChain->tunesInput() && chain.tunesInput())
+		job->warmupChain->setPhase(chain.getPhase());
+	if (job->resetState) {
+		builder_.reset(chain);
+		if (job->warmupChain)
+			builder_.reset(*job->warmupChain);
+		stream.filterSamples = 0;
+	}
+	if (job->retune) {
+		chain.retune(job->tuningNorm);
+		if (job->warmupChain)
+			job->warmupChain->retune(job->tuningNorm);
+	}
+
+	// Every chain of the stream decimates on the same grid, and a replacement picks up at the
+	// first output the chain before it did not produce
+	if (!chain.started)
+		chain.start(stream.filterSamples, job->inputComplex);
+	if (stream.lastChain && (stream.lastChain != job->chain) && !job->resetState)
+		chain.continueFrom(*stream.lastChain);
+	if (job->warmupChain && !job->warmupChain->started)
+		job->warmupChain->start(stream.filterSamples, job->inputComplex);
+
+	// Every engine reads the packet in place, straight from the dataBuffer of the getPacket()
+	// transfer, or the shared buffer of the data block, of whichever port it came from
+	InputSamples input = job->pkt->samples(job->inputComplex);
+
+	chain.run(input, job->tuned);
+
+	// Hands the samples over without a copy; chain.output[i] gets recycled storage in exchange
+	job->output.resize(chain.output.size());
+	for (size_t i=0; i < chain.output.size(); i++)
+		job->output[i] = outputPool->share(chain.output[i]);
+
+	if (job->warmupChain) {
+		// Its outputs only go out once it takes over, and then only those the current chain still owes
+		job->warmupChain->run(input, job->tuned);
+		job->warmupChain->holdOutput(chain);
+	}
+	stream.lastChain = job->chain;
+	stream.filterSamples += input.numSamples;
+
+	// Readonly measurement, published under the same lock as the readbacks of publishChain
+	if (chain.fused != NULL) {
+		const double bytesPerSample = chain.fused->getBytesPerSample();
+		boost::mutex::scoped_lock lock(configLock_);
+		BytesPerSample = bytesPerSample;
+	}
+}
+
+void TuneFilterDecimate_i::pushStage(PacketJob *job) {
+	StageTelemetry::Timer timer(telemetry_, StageTelemetry::PUSH);
+	PacketType *pkt = job->pkt;
+	bool packetPushed(false);
+	if (job->chain) {
+		const FilterChain &chain = *job->chain;
+		if (job->pushSRIs)
+			pushOutputSRIs(*job);
+
+		// Push the data to the next component: one stream, or one per channel, on either output port
+		const bool shortOutput = (dataShort_out->state() != BULKIO::IDLE);
+		for (size_t i=0; i < job->output.size(); i++) {
+			if (!job->output[i].empty() || (pkt->EOS && (chain.channelizer != NULL))) {
+				std::string outputID = (chain.channelizer != NULL) ? std::string(job->stream->channelSRIs[i].streamID) : pkt->streamID;
+				dataFloat_out->pushPacket(job->output[i], pkt->T, pkt->EOS, outputID);
+				if (shortOutput)
+					pushShortPacket(*job, i, outputID);
 				packetPushed=true;
 			}
 		}
+		if (chain.channelizer != NULL)
+			packetPushed=true; // EOS has been sent on every channel stream; the input stream ID is never used for output
 	}
 
 	if (pkt->EOS) {
 		LOG_DEBUG(TuneFilterDecimate_i, "Received EOS for stream: '" << pkt->streamID << "'");
 		if (!packetPushed)
 		{
-			std::vector<float> tmp;
-			dataFloat_out->pushPacket(tmp, pkt->T, pkt->EOS, pkt->streamID);
+			dataFloat_out->pushPacket(redhawk::shared_buffer<float>(), pkt->T, pkt->EOS, pkt->streamID);
+			dataShort_out->pushPacket(redhawk::shared_buffer<short>(), pkt->T, pkt->EOS, pkt->streamID);
 		}
-		streamID = ""; // Reset streamID on EOS to allow processing of new stream
-		RemakeFilter = true; // Ensure filter is remade on next received packet
-		// There is a desire that the tuner Phase gets reset to 0 on EOS
-		// We will solve this by deleteing the Tuner so next loop will create a brand new one
-		if (tuner != NULL) {
-			delete tuner;
-			tuner = NULL;
+	}
+
+	recordLatency(pkt->T);
+	if (telemetry_.isEnabled())
+		telemetry_.addPacket(job->chain ? pkt->samples(job->inputComplex).numSamples : 0);
+}
+
+void TuneFilterDecimate_i::pushShortPacket(PacketJob &job, size_t index, const std::string &outputID) {
+	std::vector<ShortConverter> &converters = job.stream->shortConverters;
+	if (converters.size() < job.output.size())
+		converters.resize(job.output.size());
+	ShortConverter &converter = converters[index];
+	converter.configure(job.config->ShortOutputGain, job.config->ShortOutputAGC);
+
+	// Straight from the shared float buffer into recycled storage, scaled, rounded and saturated on the way
+	const redhawk::shared_buffer<float> &samples = job.output[index];
+	size_t saturated = converter.run(samples.data(), samples.size(), job.shortOutput);
+	if (saturated != 0)
+		__sync_fetch_and_add(&ShortOutputSaturations, saturated);
+	dataShort_out->pushPacket(outputPool->share(job.shortOutput), job.pkt->T, job.pkt->EOS, outputID);
+}
+
+telemetry_struct TuneFilterDecimate_i::getTelemetry() {
+	return telemetry_.getValues();
+}
+
+CORBA::ULong TuneFilterDecimate_i::getOutputBuffers() {
+	// Counted by the pool under its own lock, so the data path never writes the property
+	return outputPool->getNumBuffers();
+}
+
+double TuneFilterDecimate_i::getOutputBufferReuse() {
+	return outputPool->getReuseRate();
+}
+
+void TuneFilterDecimate_i::recordLatency(const BULKIO::PrecisionUTCTime &T) {
+	// Other time codes need not have anything to do with the time of arrival
+	if (T.tcmode != BULKIO::TCM_CPU)
+		return;
+	BULKIO::PrecisionUTCTime now = bulkio::time::utils::now();
+	double latency = (now.twsec - T.twsec) + (now.tfsec - T.tfsec);
+
+	size_t bin = 0;
+	for (double limit=1e-6; (bin+1 < LatencyHistogram.size()) && (latency >= limit); limit *= 2)
+		bin++;
+	// The push stage of several streams can run at once; the sequence itself is never resized
+	if (bin < LatencyHistogram.size())
+		__sync_fetch_and_add(&LatencyHistogram[bin], 1);
+}
+
+void TuneFilterDecimate_i::finishJob(PacketJob *job) {
+	delete job->pkt; // Must delete the dataTransfer object when no longer needed
+	job->clear();
+}
+
+void TuneFilterDecimate_i::pushOutputSRIs(PacketJob &job) {
+	const FilterChain &chain = *job.chain;
+	StreamState &stream = *job.stream;
+	stream.channelSRIs.clear();
+	if (chain.channelizer == NULL) {
+		BULKIO::StreamSRI sri = job.outputSRI;
+		sri.xdelta = chain.decimation / (job.inputRate * chain.interpolation);
+		dataFloat_out->pushSRI(sri);
+		dataShort_out->pushSRI(sri);
+		return;
+	}
+
+	// The channel SRIs follow the input SRI, including its RF
+	for (size_t i=0; i < chain.channels.size(); i++) {
+		const ChannelSpec &channel = chain.channels[i];
+		BULKIO::StreamSRI channelSRI = job.outputSRI;
+		std::ostringstream channelID;
+		channelID << stream.streamID << "_ch" << i;
+		channelSRI.streamID = CORBA::string_dup(channelID.str().c_str());
+		channelSRI.xdelta = FilterChainBuilder::channelDecimation(channel, job.inputRate) / job.inputRate;
+		if (job.inputRF != 0) {
+			if(!setKeywordByID<CORBA::Double>(channelSRI, "CHAN_RF", job.inputRF + channel.tuningIF - job.chan_if))
+				LOG_WARN(TuneFilterDecimate_i, "SRI Keyword CHAN_RF could not be set.");
 		}
+		stream.channelSRIs.push_back(channelSRI);
+		dataFloat_out->pushSRI(channelSRI);
+		dataShort_out->pushSRI(channelSRI);
 	}
+}
 
-	delete pkt; // Must delete the dataTransfer object when no longer needed
+// Compares the parts of the SRI configureTFD() depends on; anything else only ends up in the output SRI
+StageTelemetry::SRIChange TuneFilterDecimate_i::classifySRIChange(const BULKIO::StreamSRI &sri, const StreamState &stream) {
+	const BULKIO::StreamSRI &last = stream.inputSRI;
+	if (sri.xdelta != last.xdelta)
+		return StageTelemetry::SRI_RATE;
+	if (sri.mode != last.mode)
+		return StageTelemetry::SRI_MODE;
 
-	return NORMAL;
+	static const char* const rfKeywords[] = { "COL_RF", "CHAN_RF" };
+	for (size_t i=0; i < 2; i++) {
+		bool valid = false;
+		bool lastValid = false;
+		double rf = getKeywordByID<CORBA::Double>(sri, rfKeywords[i], valid);
+		double lastRF = getKeywordByID<CORBA::Double>(last, rfKeywords[i], lastValid);
+		if ((valid != lastValid) || (valid && (rf != lastRF)))
+			return StageTelemetry::SRI_RF;
+	}
+	return StageTelemetry::SRI_KEYWORDS;
+}
+
+void TuneFilterDecimate_i::updateSRIKeywords(BULKIO::StreamSRI &sri, StreamState &stream, const ConfigSnapshot &config) {
+	// The same changes configureTFD() makes to the SRI, from what it worked out before
+	sri.mode = 1;
+	sri.xdelta = stream.outputSRI.xdelta;
+	if (stream.inputRF != 0) {
+		if(!setKeywordByID<CORBA::Double>(sri, "CHAN_RF", streamChannelRF(stream, config)))
+			LOG_WARN(TuneFilterDecimate_i, "SRI Keyword CHAN_RF could not be set.");
+	}
+	stream.outputSRI = sri;
 }
 
-void TuneFilterDecimate_i::configureTFD(BULKIO::StreamSRI &sri) {
+void TuneFilterDecimate_i::configureTFD(BULKIO::StreamSRI &sri, const StreamStatePtr &streamPtr, const ConfigSnapshot &config) {
+	StreamState &stream = *streamPtr;
 	LOG_TRACE(TuneFilterDecimate_i, "Configuring SRI: "
 			<< "sri.xdelta = " << sri.xdelta
 			<< "sri.streamID = " << sri.streamID)
 					Real tmpInputSampleRate = 1 / sri.xdelta; // Calculate sample rate received from SRI
-	bool lastInputComplex = inputComplex;
+	bool lastInputComplex = stream.inputComplex;
 	if (sri.mode==1)
 	{
-		inputComplex=true;
-		chan_if =0.0; //center of band is 0 if we are complex
+		stream.inputComplex=true;
+		stream.chan_if =0.0; //center of band is 0 if we are complex
 	}
 	else
 	{
-		inputComplex = false;
-		chan_if = tmpInputSampleRate/4.0; //center of band is fs/4 if we are real
+		stream.inputComplex = false;
+		stream.chan_if = tmpInputSampleRate/4.0; //center of band is fs/4 if we are real
 		//output is always complex even if input is real
 		sri.mode=1;
 	}
 
-	DecimationFactor = floor(tmpInputSampleRate/DesiredOutputRate);
-	LOG_DEBUG(TuneFilterDecimate_i, "DecimationFactor = " << DecimationFactor);
-	if (DecimationFactor <1) {
+	double decimationFactor = floor(tmpInputSampleRate/config.DesiredOutputRate);
+	size_t interpolationFactor = 1;
+	if (config.RationalResampling && config.channels.empty()) {
+		size_t decimation;
+		FilterDesign::ratioFor(tmpInputSampleRate, config.DesiredOutputRate, config.ResampleTolerance, interpolationFactor, decimation);
+		decimationFactor = decimation;
+		LOG_DEBUG(TuneFilterDecimate_i, "Resampling by " << interpolationFactor << "/" << decimationFactor);
+	}
+	LOG_DEBUG(TuneFilterDecimate_i, "DecimationFactor = " << decimationFactor);
+	if (decimationFactor <1) {
 		LOG_WARN(TuneFilterDecimate_i, "Decimation less than 1, setting to minimum")
-						DecimationFactor=1;
+						decimationFactor=1;
 	}
 
-	bool sampleRateChanged =(InputRate != tmpInputSampleRate);
+	bool sampleRateChanged =(stream.inputRate != tmpInputSampleRate);
 	if (sampleRateChanged)
 	{
-		InputRate = tmpInputSampleRate;
-		LOG_DEBUG(TuneFilterDecimate_i, "Sample rate changed: InputRate = " << InputRate);
+		stream.inputRate = tmpInputSampleRate;
+		LOG_DEBUG(TuneFilterDecimate_i, "Sample rate changed: InputRate = " << stream.inputRate);
 	}
 
 	// Calculate new output sample rate & modify the referenced SRI structure
-	ActualOutputRate = InputRate / DecimationFactor;
-	sri.xdelta = 1.0 / ActualOutputRate;
+	double actualOutputRate = stream.inputRate * interpolationFactor / decimationFactor;
+	sri.xdelta = 1.0 / actualOutputRate;
 	LOG_DEBUG(TuneFilterDecimate_i, "Output xdelta = " << sri.xdelta
-			<< " ActualOutputRate " << ActualOutputRate);
+			<< " ActualOutputRate " << actualOutputRate);
+
+	if (actualOutputRate < config.FilterBW)
+		LOG_WARN(TuneFilterDecimate_i, "ActualOutputRate " << actualOutputRate << " is less than FilterBW " << config.FilterBW);
 
-	if (ActualOutputRate < FilterBW)
-		LOG_WARN(TuneFilterDecimate_i, "ActualOutputRate " << ActualOutputRate << " is less than FilterBW " << FilterBW);
+	{
+		// The readback properties follow the stream most recently configured
+		boost::mutex::scoped_lock lock(configLock_);
+		chan_if = stream.chan_if;
+		DecimationFactor = decimationFactor;
+		InterpolationFactor = interpolationFactor;
+		InputRate = stream.inputRate;
+		ActualOutputRate = actualOutputRate;
+	}
 
 	// Retrieve the front-end collected RF to determine the IF
 	bool validCollectionRF = false;
@@ -394,122 +1111,184 @@ void TuneFilterDecimate_i::configureTFD(BULKIO::StreamSRI &sri) {
 	} else if (validChannelRF) {
 		tmpInputRF = channel_rf;
 	} else {
-		if (TuneMode == "RF") {
+		if (config.TuneMode == "RF") {
 			LOG_WARN(TuneFilterDecimate_i, "Input SRI lacks RF keyword.  RF tuning cannot be performed.");
 			return;
 		}
 		tmpInputRF = 0;
 	}
-	bool inputComplexChanged = lastInputComplex ^ inputComplex;
+	bool inputComplexChanged = lastInputComplex ^ stream.inputComplex;
+	bool inputRFChanged = (tmpInputRF != stream.inputRF);
+	bool remakeTuner = !stream.tuner || sampleRateChanged;
+	stream.inputRF = tmpInputRF;
 
-	if (tmpInputRF != InputRF) {
-		LOG_DEBUG(TuneFilterDecimate_i, "Input RF changed " << tmpInputRF);
-		InputRF = tmpInputRF;
+	{
+		// Update the tuning readbacks; the tuning of the streams does not depend on them, so
+		// the snapshot is republished without asking any stream to retune
+		boost::mutex::scoped_lock lock(configLock_);
+		InputRF = stream.inputRF;
+		if (inputRFChanged) {
+			LOG_DEBUG(TuneFilterDecimate_i, "Input RF changed " << tmpInputRF);
 
-		// If the TuneMode is RF, we actually need to retune
-		if (TuneMode == "RF") {
+			// If the TuneMode is RF, we actually need to retune
+			if (TuneMode == "RF") {
+				configureTuner("TuningRF");
+				stream.retune = true;
+			} else if (TuneMode == "NORM") {
+				configureTuner("TuningNorm");
+				stream.retune = true;
+			}
+			TuningRF = InputRF + TuningIF - chan_if;
+			LOG_DEBUG(TuneFilterDecimate_i, "Tuning RF: " << TuningRF);
+		}
+		else if (TuneMode == "RF" && inputComplexChanged)
+		{
+			//the RF didn't change but the IF is changing because we have switched between real and complex data
 			configureTuner("TuningRF");
-        } else if (TuneMode == "NORM") {
-            configureTuner("TuningNorm");
-        }
-		TuningRF = InputRF + TuningIF - chan_if;
-		LOG_DEBUG(TuneFilterDecimate_i, "Tuning RF: " << TuningRF);
-	}
-	else if (TuneMode == "RF" && inputComplexChanged)
-	{
-		//the RF didn't change but the IF is changing because we have switched between real and complex data
-		configureTuner("TuningRF");
-		LOG_DEBUG(TuneFilterDecimate_i, "Tuning RF: " << TuningRF);
+			stream.retune = true;
+			LOG_DEBUG(TuneFilterDecimate_i, "Tuning RF: " << TuningRF);
+		}
+
+		if (remakeTuner) {
+			if (TuneMode == "NORM") {
+				configureTuner("TuningNorm");
+			} else if (TuneMode == "IF") {
+				configureTuner("TuningIF");
+			} else if (TuneMode == "RF") {
+				configureTuner("TuningRF");
+			}
+		}
+		publishConfig();
 	}
 
 	// Add the CHAN_RF keyword to the SRI if we know the input RF
-	if (InputRF != 0) {
-		if(!setKeywordByID<CORBA::Double>(sri, "CHAN_RF", (double)TuningRF))
+	if (stream.inputRF != 0) {
+		if(!setKeywordByID<CORBA::Double>(sri, "CHAN_RF", streamChannelRF(stream, config)))
 			LOG_WARN(TuneFilterDecimate_i, "SRI Keyword CHAN_RF could not be set.");
 	}
 
 	// Reconfigure the tuner classes only if the sample rate has changed
-	if ((tuner== NULL) || sampleRateChanged) {
+	if (remakeTuner) {
 		LOG_DEBUG(TuneFilterDecimate_i, "Remaking tuner");
 
-		if (tuner != NULL) {
-			delete tuner;
-		}
-
-		if (TuneMode == "NORM") {
-			configureTuner("TuningNorm");
-		} else if (TuneMode == "IF") {
-			configureTuner("TuningIF");
-		} else if (TuneMode == "RF") {
-			configureTuner("TuningRF");
-		}
-
-		tuner = new Tuner(tunerInput, f_complexIn, TuningNorm);
+		stream.tuner.reset(new Mixer(streamTuningNorm(stream, config)));
+		stream.retune = false;
 	}
 
-	if ((filter==NULL) || sampleRateChanged || RemakeFilter) {
-		LOG_DEBUG(TuneFilterDecimate_i, "Remaking filter");
+	stream.outputSRI = sri;
 
-		if((filter != NULL) || (decimate != NULL)) {
-			delete filter;
-			delete decimate;
+	if (!stream.chain || sampleRateChanged || stream.remakeFilter) {
+		FilterDesign design = makeFilterDesign(stream, config, interpolationFactor, decimationFactor);
+		if (design.transitionWidth != Real(config.filterProps.TransitionWidth)) {
+			// Keep the reduced transition width, as if it had been configured
+			boost::mutex::scoped_lock lock(configLock_);
+			filterProps.TransitionWidth = design.transitionWidth;
+			publishConfig();
 		}
-/*
- *                    ASCII ART to explain the filter design
- *
- *  Lowpass (Real filter)
- *  ---------|
- *           \
- *            \
- *             \
- *              |
- *  ----------------------------------
- *  0        FL FL+tw   fsOut/2   fsIn/2
- *
- *  The basic gist is we tune first, then filter.
- *  Then we filter
- *  Then we decimate
- *
- *  This means the filter is a LOWPASS filter which must be designed given the INPUT sampling frequency.
- *  The transition frequency happens at 1/2 the requested tune bandwidth.  Thus FL = FilterBW / 2.0.
- *  We need the transition region to "finish" by fsOut/2 to avoid aliasing, so we do a check for that too.
- *
- */
-		Real FL = FilterBW / 2.0;
 
-		//calculate the transition frequency necessary to avoid aliasing
-		Real maxTW = (ActualOutputRate/2.0)-FL;
-		if (maxTW > 0 && maxTW <  filterProps.TransitionWidth)
+		// There is no history worth keeping for a new stream or sample rate, so build the new chain right away
+		bool buildNow = !stream.chain || sampleRateChanged || (builderPool == NULL);
 		{
-			LOG_WARN(TuneFilterDecimate_i, "input transition width "<< filterProps.TransitionWidth<<"  too large - replacing with "<< maxTW);
-			filterProps.TransitionWidth = maxTW;
+			boost::mutex::scoped_lock lock(TuneFilterDecimateLock_);
+			stream.rebuildGeneration++; // anything still being built for the old settings is stale
+			stream.pendingChain.reset();
+			if (buildNow) {
+				stream.designPending = false;
+			} else {
+				// Keep running the current chain while the new one is designed and planned on the builder thread
+				stream.nextDesign = design;
+				if (!stream.designPending) {
+					stream.designPending = true;
+					stream.dispatchRebuild = true;
+				}
+			}
 		}
+		stream.warmupChain.reset();
 
-		// We generate our FIR filter taps here. The read-only property 'taps' is set.
-		// 	- We use the transition width and ripple specified by the user to create the filter taps.
-		// 	- Normalized lowpass cutoff frequency is the only one we need; upper cutoff not used
-		RealVector tmpVec;
-		taps = filterdesigner_.wdfirHz(tmpVec, FIRFilter::lowpass, filterProps.Ripple, filterProps.TransitionWidth,
-				FL, 0, InputRate, MIN_NUM_TAPS, MAX_NUM_TAPS);
-		filterCoeff.clear();
-		filterCoeff.reserve(tmpVec.size());
-		for (RealVector::iterator i = tmpVec.begin(); i!=tmpVec.end(); i++)
-			filterCoeff.push_back(*i);
-
-		// Minimum FFT_size implemented
-		size_t minFftSize = std::max(MIN_FFT_SIZE, pow2ge(2*taps));
-		if(filterProps.FFT_size < minFftSize) {
-			LOG_DEBUG(TuneFilterDecimate_i, "FFT_size too small, set to " << minFftSize);
-			filterProps.FFT_size = minFftSize;
-		} else if (filterProps.FFT_size > MAX_FFT_SIZE)
-		{
-			LOG_DEBUG(TuneFilterDecimate_i, "FFT_size too large, set to " << MAX_FFT_SIZE);
-			filterProps.FFT_size = MAX_FFT_SIZE;
+		if (buildNow) {
+			LOG_DEBUG(TuneFilterDecimate_i, "Remaking filter");
+
+			// The filter stage carries the mixer phase of a chain that tunes itself over (see preparePacket())
+			stream.chain.reset();
+			stream.chain = buildFilterChain(design);
+			publishChain(*stream.chain);
+			updateCacheCounters();
+		} else {
+			LOG_DEBUG(TuneFilterDecimate_i, "Remaking filter in the background");
 		}
-		filter = new firfilter(filterProps.FFT_size, f_realOut, f_complexOut, filterCoeff);
-		decimate = new Decimate(f_complexOut, decimateOutput, DecimationFactor);
-		RemakeFilter = false;	
+		stream.remakeFilter = false;
 	}
 
 	LOG_TRACE(TuneFilterDecimate_i, "Exit configureSRI()");
 }
+
+FilterDesign TuneFilterDecimate_i::makeFilterDesign(const StreamState &stream, const ConfigSnapshot &config, size_t interpolation, size_t decimation) {
+	FilterDesign design;
+	design.engine = config.FilterEngine;
+	design.inputRate = stream.inputRate;
+	design.inputComplex = stream.inputComplex;
+	design.decimation = decimation;
+	design.interpolation = interpolation;
+	design.ripple = config.filterProps.Ripple;
+	design.fftSize = config.filterProps.FFT_size;
+	design.autoFftSize = config.AutoFFTSize;
+	design.partitionSize = config.PartitionSize;
+	design.tuningNorm = streamTuningNorm(stream, config);
+	for (size_t i=0; i < config.channels.size(); i++) {
+		const channel_struct &channel = config.channels[i];
+		design.channels.push_back(ChannelSpec(channel.TuningIF, channel.FilterBW, channel.DesiredOutputRate));
+	}
+
+	if (!design.setPassband(config.FilterBW, config.filterProps.TransitionWidth))
+		LOG_WARN(TuneFilterDecimate_i, "input transition width "<< config.filterProps.TransitionWidth<<"  too large - replacing with "<< design.transitionWidth);
+	return design;
+}
+
+FilterChainPtr TuneFilterDecimate_i::buildFilterChain(const FilterDesign &design) {
+	StageTelemetry::Timer timer(telemetry_, StageTelemetry::REBUILD);
+	FilterChainPtr chain = builder_.build(design);
+	LOG_DEBUG(TuneFilterDecimate_i, "Using " << chain->engine << " filter engine: " << chain->stages
+			<< ", FFT size " << chain->fftSize << ", estimated " << chain->costPerSample << " ns per sample");
+	return chain;
+}
+
+void TuneFilterDecimate_i::rebuildChain(RebuildJob *job) {
+	StreamState &stream = *job->stream;
+	FilterDesign design;
+	unsigned int generation;
+	{
+		boost::mutex::scoped_lock lock(TuneFilterDecimateLock_);
+		if (!stream.designPending)
+			return; // already built inline, or picked up by an earlier job
+		design = stream.nextDesign;
+		generation = stream.rebuildGeneration;
+		stream.designPending = false;
+	}
+
+	LOG_DEBUG(TuneFilterDecimate_i, "Building new filter for stream: '" << stream.streamID << "'");
+	FilterChainPtr chain = buildFilterChain(design);
+	updateCacheCounters();
+
+	boost::mutex::scoped_lock lock(TuneFilterDecimateLock_);
+	if (generation != stream.rebuildGeneration) {
+		LOG_DEBUG(TuneFilterDecimate_i, "Discarding stale filter for stream: '" << stream.streamID << "'");
+		return;
+	}
+	// The stream's own thread swaps it in at the next packet boundary
+	stream.pendingChain = chain;
+}
+
+void TuneFilterDecimate_i::publishChain(const FilterChain &chain) {
+	boost::mutex::scoped_lock lock(configLock_);
+	taps = chain.numTaps;
+	DecimationStages = chain.stages;
+	ActiveFilterEngine = chain.engine;
+	FilterCost = chain.costPerSample;
+	BytesPerSample = chain.bytesPerSample;
+	FilterLatency = chain.latency();
+	FilterLatencyTime = (InputRate > 0) ? FilterLatency/InputRate : 0.0;
+	// Report the FFT size in use; the streams keep designing from the configured one (see publishConfig)
+	if ((chain.fftSize != 0) && (chain.channelizer == NULL))
+		filterProps.FFT_size = chain.fftSize;
+}
+
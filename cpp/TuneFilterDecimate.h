@@ -18,12 +18,23 @@
 #ifndef TUNEFILTERDECIMATE_IMPL_H
 #define TUNEFILTERDECIMATE_IMPL_H
 
+#include <algorithm>
+#include <cstdlib>
+#include <deque>
+#include <map>
+#include <sstream>
+#include <boost/shared_ptr.hpp>
+
 #include "TuneFilterDecimate_base.h"
 #include "DataTypes.h"
-#include "Tuner.h"
-#include "firfilter.h"
-#include "FirFilterDesigner.h"
-#include "Decimate.h"
+#include "FilterChainBuilder.h"
+#include "StageTelemetry.h"
+#include "ConfigSnapshot.h"
+#include "InputPacket.h"
+#include "StreamState.h"
+#include "OutputBufferPool.h"
+#include "PacketWorkerPool.h"
+#include "PacketPipeline.h"
 
 class TuneFilterDecimate_i;
 
@@ -36,10 +47,143 @@ public:
 	int serviceFunction();
 
 	void start() throw (CORBA::SystemException, CF::Resource::StartError);
+	void stop() throw (CORBA::SystemException, CF::Resource::StopError);
 
 private:
+	typedef InputPacket PacketType;
+	typedef boost::shared_ptr<StreamState> StreamStatePtr;
+	typedef std::map<std::string, StreamStatePtr> StreamMap;
+
+	// Request for the background builder to design a new filter chain for a stream
+	struct RebuildJob
+	{
+		StreamStatePtr stream;
+	};
+
+	// One packet on its way through the tune, filter and push stages.  preparePacket() copies
+	// everything the later stages need from the stream, so that in pipelined mode the next
+	// packet of the stream can be prepared while this one is still being processed.
+	struct PacketJob
+	{
+		PacketJob() :
+			pkt(NULL),
+			inputComplex(true),
+			retune(false),
+			tuningNorm(0.0),
+			inheritPhase(false),
+			startWarmup(false),
+			resetState(false),
+			pushSRIs(false),
+			inputRate(0.0),
+			inputRF(0.0),
+			chan_if(0.0)
+		{
+		}
+
+		// Drop the references to the packet's stream and data; keeps the buffer storage
+		void clear();
+
+		PacketType *pkt;
+		StreamStatePtr stream;
+		ConfigSnapshotPtr config;
+		bool inputComplex;
+
+		// Processing classes; chain is NULL when the packet is dropped
+		boost::shared_ptr<Mixer> tuner;
+		FilterChainPtr chain;
+		FilterChainPtr warmupChain;
+
+		bool retune;       // tuner and chains that tune themselves pick up tuningNorm first
+		double tuningNorm;
+		bool inheritPhase; // chain replaces the chain of the previous packet and continues its mixer phase
+		bool startWarmup;  // warmupChain is new and starts from the mixer phase of chain
+		bool resetState;   // tuner, chain and warmupChain start over from an empty history first
+
+		// Copies of the stream's output SRI parameters, when pushSRIs
+		bool pushSRIs;
+		BULKIO::StreamSRI outputSRI;
+		double inputRate;
+		double inputRF;
+		double chan_if;
+
+		firfilter::complexVector tuned;                    // tuner output
+		std::vector<redhawk::shared_buffer<float> > output; // one per output stream
+		std::vector<short> shortOutput;                     // storage for dataShort_out
+	};
+
+	// Next packet from any of the input ports, waiting up to timeout seconds if there is none
+	// CPUs of a PipelineCPUs list; entries that are not CPU numbers or ranges are skipped with a warning
+	std::vector<int> parseCpuList(const std::string& list);
+
+	PacketType* getPacket(float timeout);
+	PacketType* getPacket(size_t port, float timeout);
+	template <typename PORT> PacketType* getPortPacket(PORT *port, InputSamples::Format format, float timeout);
+	template <typename PORT> PacketType* getStreamPacket(PORT *port, InputSamples::Format format, float timeout);
+	template <typename STREAM, typename BLOCK, typename SCALAR>
+	PacketType* newStreamPacket(STREAM &stream, const BLOCK &block, const redhawk::shared_buffer<SCALAR> &buffer,
+			InputSamples::Format format);
+
+	// Run one packet through the tuner/filter/decimator of its stream, on the calling thread
+	void processPacket(PacketType *pkt);
+
+	// The stages of processPacket(), run on separate threads when PipelineThreads > 0.
+	// preparePacket() handles SRI and configuration changes and must see the packets of a
+	// stream in order; tuneStage(), filterStage() and pushStage() only use the job.
+	void preparePacket(PacketJob *job);
+	void tuneStage(PacketJob *job);
+	void filterStage(PacketJob *job);
+	void pushStage(PacketJob *job);
+	void finishJob(PacketJob *job);
+
+	// Push output stream index of a job on dataShort_out as well
+	void pushShortPacket(PacketJob &job, size_t index, const std::string &outputID);
+
+	// Query functions of the telemetry and output buffer properties
+	telemetry_struct getTelemetry();
+	CORBA::ULong getOutputBuffers();
+	double getOutputBufferReuse();
+
+	// Count a pushed packet in LatencyHistogram
+	void recordLatency(const BULKIO::PrecisionUTCTime &T);
+
+	// Find the state for a stream ID, creating it on first use.  Call with TuneFilterDecimateLock_ held.
+	StreamStatePtr getStream(const std::string& id);
+
+	// Keep the state of a stream that reached EOS for the next stream with the same ID, forgetting
+	// the oldest ended stream beyond MAX_ENDED_STREAMS.  Call with TuneFilterDecimateLock_ held.
+	void endStream(const std::string& id);
+
+	// Flag the work a new configuration snapshot requires of a stream
+	void applyConfig(StreamState &stream, const ConfigSnapshotPtr &config);
+
+	// What an SRI change of a configured stream requires, compared with the SRI it was configured from
+	StageTelemetry::SRIChange classifySRIChange(const BULKIO::StreamSRI &sri, const StreamState &stream);
+
+	// Apply an SRI that only changed keywords, leaving the tuner and the filter alone
+	void updateSRIKeywords(BULKIO::StreamSRI &sri, StreamState &stream, const ConfigSnapshot &config);
+
 	// Handle changes to the SRI
-	void configureTFD(BULKIO::StreamSRI &sri);
+	void configureTFD(BULKIO::StreamSRI &sri, const StreamStatePtr &streamPtr, const ConfigSnapshot &config);
+
+	// Everything needed to build the filter chain of a stream, taken from a configuration snapshot
+	FilterDesign makeFilterDesign(const StreamState &stream, const ConfigSnapshot &config, size_t interpolation, size_t decimation);
+
+	// Design and construct a filter chain; does not need the component lock
+	FilterChainPtr buildFilterChain(const FilterDesign &design);
+
+	// Background builder thread: build the latest design requested for a stream
+	void rebuildChain(RebuildJob *job);
+
+	// Update the readonly properties that describe the filter in use
+	void publishChain(const FilterChain &chain);
+	void updateCacheCounters();
+
+	// Push the SRI of every output stream produced by the chain of a job
+	void pushOutputSRIs(PacketJob &job);
+
+	// Import or export FFTW wisdom if FFTWWisdomFile is set
+	void loadWisdom();
+	void saveWisdom();
 
 	// ** Functions to generate tap coefficients for a lowpass filter.
 	int generateTaps(const double& sFreq, const double& dOmega, const double& delta, Real fl = Real(0.5)); // returns # of taps
@@ -50,8 +194,23 @@ private:
 	void configureFilter(const std::string& propid);
 	void configureTuner(const std::string& propid);
 
+	// Tuning frequency of a stream, which depends on its own sample rate and RF
+	double streamTuningNorm(const StreamState &stream, const ConfigSnapshot &config);
+	double streamChannelRF(const StreamState &stream, const ConfigSnapshot &config);
+
+	// Samples a replacement chain must run before it takes over: its own history, the current
+	// chain's latency so it has caught up on outputs, and one decimation grid period
+	size_t warmupLength(const StreamState &stream);
+
+	// Publish a new configuration snapshot from the property values; must be called with configLock_ held
+	void publishConfig();
+
+	// Publish a snapshot that makes every stream retune or remake its filter; must be called with configLock_ held
+	void retuneStreams();
+	void remakeFilters();
+
 	// Function to get an SRI keyword value
-	template <typename TYPE> TYPE getKeywordByID(BULKIO::StreamSRI &sri, CORBA::String_member id, bool &valid) {
+	template <typename TYPE> TYPE getKeywordByID(const BULKIO::StreamSRI &sri, CORBA::String_member id, bool &valid) {
 		/****************************************************************************************************
 		 * Description: Retrieve the value assigned to a given id.
 		 * sri   - StreamSRI object to process
@@ -118,49 +277,75 @@ private:
 		return true;
 	}
 
-	// Processing classes
-	Tuner *tuner;
-	firfilter *filter;
-	Decimate *decimate;
+	// Per-stream processing state, keyed by stream ID
+	StreamMap streams;
 
-	// Internal buffers
-	ComplexVector tunerInput;
-	ComplexVector decimateOutput;
-	std::vector<float> floatBuffer; // output buffer
+	// IDs of the streams in streams that have ended, oldest first
+	std::deque<std::string> endedStreams;
+	const static size_t MAX_ENDED_STREAMS;
 
-	// Input buffers for the FIR filter are fed as output buffers to the Tuner object.
-	// Output buffers for the FIR filter are set as input buffers to the Decimate object.
-	firfilter::complexVector f_complexIn;
-	firfilter::realVector f_realOut;
-	firfilter::complexVector f_complexOut;
-	// All of these are REQUIRED by firfilter's constructor, whether we are filtering real or complex data.
-	// DO NOT REMOVE.
+	// Threads processing the streams when WorkerThreads > 0
+	PacketWorkerPool<PacketType> *workerPool;
 
-	RealFFTWVector filterCoeff; // To set the taps for the filter. Only real taps for current implementation.
+	// Threads running the stages after preparePacket() when PipelineThreads > 0
+	PacketPipeline<PacketJob> *pipeline;
+
+	// Thread designing replacement filters for running streams
+	PacketWorkerPool<RebuildJob> *builderPool;
+
+	// Input port that delivered the most recent packet: 0 float, 1 short, 2 octet
+	size_t lastInputPort;
+	// Longest wait on one input port before trying the next, in seconds
+	const static float WAIT_SLICE;
+	// Read the input through the bulkio stream API instead of getPacket(); UseStreamAPI at start()
+	bool useStreamAPI;
+
+	// Storage of the output packets, shared by all streams
+	OutputBufferPoolPtr outputPool;
 
 	// Private variables
-	Real inputSampleRate;
-	double chan_if;
-	bool tuningRFChanged; // Used to indicate if TuningRF has been changed so the CHAN_RF keyword can be added to SRI
-	bool RemakeFilter;    // Used to indicate we must redo the filter
-	std::string streamID;
-	bool inputComplex;
+	double chan_if; // chan_if of the stream most recently configured
 	//values set in TuneFilterDecimate.cpp
-	const static size_t MIN_NUM_TAPS;
-	const static size_t MAX_NUM_TAPS;
-	const static size_t MIN_FFT_SIZE;
-	const static size_t MAX_FFT_SIZE;
-    FirFilterDesigner filterdesigner_;
+	const static size_t LATENCY_BINS;
+    // Filter design, design cache and FFTW planning, with their own locks, which are
+    // taken after the component's locks when both are needed
+    FilterChainBuilder builder_;
+    // Stage timing and event counts for the telemetry property; updated atomically by the data path
+    StageTelemetry telemetry_;
 
     // Property Change Listener Callbacks
+    void TuneModeChanged(const std::string *oldValue, const std::string *newValue);
     void TuningNormChanged(const double *oldValue, const double *newValue);
     void TuningIFChanged(const double *oldValue, const double *newValue);
     void TuningRFChanged(const CORBA::ULongLong *oldValue, const CORBA::ULongLong *newValue);
     void FilterBWChanged(const float *oldValue, const float *newValue);
     void DesiredOutputRateChanged(const float *oldValue, const float *newValue);
     void filterPropsChanged(const filterProps_struct *oldValue, const filterProps_struct *newValue);
+    void FilterEngineChanged(const std::string *oldValue, const std::string *newValue);
+    void AutoFFTSizeChanged(const bool *oldValue, const bool *newValue);
+    void PartitionSizeChanged(const CORBA::ULong *oldValue, const CORBA::ULong *newValue);
+    void RationalResamplingChanged(const bool *oldValue, const bool *newValue);
+    void ResampleToleranceChanged(const double *oldValue, const double *newValue);
+    void DesignCacheSizeChanged(const CORBA::ULong *oldValue, const CORBA::ULong *newValue);
+    void FFTWWisdomFileChanged(const std::string *oldValue, const std::string *newValue);
+    void ShortOutputGainChanged(const float *oldValue, const float *newValue);
+    void ShortOutputAGCChanged(const bool *oldValue, const bool *newValue);
+    void TelemetryEnabledChanged(const bool *oldValue, const bool *newValue);
+    void channelsChanged(const std::vector<channel_struct> *oldValue, const std::vector<channel_struct> *newValue);
+
+    // Latest configuration snapshot, only accessed with boost::atomic_load and boost::atomic_store
+    ConfigSnapshotPtr config_;
+    unsigned int configVersion_;
+    unsigned int tuningVersion_;
+    unsigned int filterVersion_;
+    // filterProps.FFT_size as configured; the property itself reports the size in use
+    CORBA::ULong configuredFftSize_;
 
+    // Guards the stream map and the hand-off of rebuilt chains; never held while running the DSP
     boost::mutex TuneFilterDecimateLock_;
+    // Guards the property members and publishing snapshots; never held while running the DSP,
+    // and never taken together with TuneFilterDecimateLock_
+    boost::mutex configLock_;
 };
 
 #endif
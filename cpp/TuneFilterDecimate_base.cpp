@@ -35,16 +35,28 @@ TuneFilterDecimate_base::TuneFilterDecimate_base(const char *uuid, const char *l
 
     dataFloat_in = new bulkio::InFloatPort("dataFloat_in");
     addPort("dataFloat_in", dataFloat_in);
+    dataShort_in = new bulkio::InShortPort("dataShort_in");
+    addPort("dataShort_in", dataShort_in);
+    dataOctet_in = new bulkio::InOctetPort("dataOctet_in");
+    addPort("dataOctet_in", dataOctet_in);
     dataFloat_out = new bulkio::OutFloatPort("dataFloat_out");
     addPort("dataFloat_out", dataFloat_out);
+    dataShort_out = new bulkio::OutShortPort("dataShort_out");
+    addPort("dataShort_out", dataShort_out);
 }
 
 TuneFilterDecimate_base::~TuneFilterDecimate_base()
 {
     delete dataFloat_in;
     dataFloat_in = 0;
+    delete dataShort_in;
+    dataShort_in = 0;
+    delete dataOctet_in;
+    dataOctet_in = 0;
     delete dataFloat_out;
     dataFloat_out = 0;
+    delete dataShort_out;
+    dataShort_out = 0;
 }
 
 /*******************************************************************************************
@@ -167,6 +179,33 @@ void TuneFilterDecimate_base::loadProperties()
                 "external",
                 "configure");
 
+    addProperty(RationalResampling,
+                false,
+                "RationalResampling",
+                "",
+                "readwrite",
+                "",
+                "external",
+                "configure");
+
+    addProperty(ResampleTolerance,
+                1e-6,
+                "ResampleTolerance",
+                "",
+                "readwrite",
+                "",
+                "external",
+                "configure");
+
+    addProperty(InterpolationFactor,
+                1,
+                "InterpolationFactor",
+                "",
+                "readonly",
+                "",
+                "external",
+                "configure");
+
     addProperty(taps,
                 "taps",
                 "",
@@ -184,6 +223,245 @@ void TuneFilterDecimate_base::loadProperties()
                 "external",
                 "configure");
 
+    addProperty(AutoFFTSize,
+                false,
+                "AutoFFTSize",
+                "",
+                "readwrite",
+                "",
+                "external",
+                "configure");
+
+    addProperty(FilterEngine,
+                "FFT",
+                "FilterEngine",
+                "",
+                "readwrite",
+                "",
+                "external",
+                "configure");
+
+    addProperty(ActiveFilterEngine,
+                "ActiveFilterEngine",
+                "",
+                "readonly",
+                "",
+                "external",
+                "configure");
+
+    addProperty(FilterCost,
+                0.0,
+                "FilterCost",
+                "",
+                "readonly",
+                "ns",
+                "external",
+                "configure");
+
+    addProperty(PartitionSize,
+                1024,
+                "PartitionSize",
+                "",
+                "readwrite",
+                "samples",
+                "external",
+                "configure");
+
+    addProperty(FilterLatency,
+                0,
+                "FilterLatency",
+                "",
+                "readonly",
+                "samples",
+                "external",
+                "configure");
+
+    addProperty(FilterLatencyTime,
+                0.0,
+                "FilterLatencyTime",
+                "",
+                "readonly",
+                "s",
+                "external",
+                "configure");
+
+    addProperty(WorkerThreads,
+                0,
+                "WorkerThreads",
+                "",
+                "readwrite",
+                "",
+                "external",
+                "configure");
+
+    addProperty(PipelineThreads,
+                0,
+                "PipelineThreads",
+                "",
+                "readwrite",
+                "",
+                "external",
+                "configure");
+
+    addProperty(PipelineCPUs,
+                "",
+                "PipelineCPUs",
+                "",
+                "readwrite",
+                "",
+                "external",
+                "configure");
+
+    addProperty(PacketTimeout,
+                0.0,
+                "PacketTimeout",
+                "",
+                "readwrite",
+                "s",
+                "external",
+                "configure");
+
+    addProperty(UseStreamAPI,
+                false,
+                "UseStreamAPI",
+                "",
+                "readwrite",
+                "",
+                "external",
+                "configure");
+
+    addProperty(BytesPerSample,
+                0.0,
+                "BytesPerSample",
+                "",
+                "readonly",
+                "bytes",
+                "external",
+                "configure");
+
+    addProperty(DecimationStages,
+                "DecimationStages",
+                "",
+                "readonly",
+                "",
+                "external",
+                "configure");
+
+    addProperty(DesignCacheSize,
+                16,
+                "DesignCacheSize",
+                "",
+                "readwrite",
+                "",
+                "external",
+                "configure");
+
+    addProperty(DesignCacheHits,
+                0,
+                "DesignCacheHits",
+                "",
+                "readonly",
+                "",
+                "external",
+                "configure");
+
+    addProperty(DesignCacheMisses,
+                0,
+                "DesignCacheMisses",
+                "",
+                "readonly",
+                "",
+                "external",
+                "configure");
+
+    addProperty(FFTWWisdomFile,
+                "",
+                "FFTWWisdomFile",
+                "",
+                "readwrite",
+                "",
+                "external",
+                "configure");
+
+    addProperty(OutputBuffers,
+                0,
+                "OutputBuffers",
+                "",
+                "readonly",
+                "",
+                "external",
+                "configure");
+
+    addProperty(OutputBufferReuse,
+                0.0,
+                "OutputBufferReuse",
+                "",
+                "readonly",
+                "",
+                "external",
+                "configure");
+
+    addProperty(LatencyHistogram,
+                "LatencyHistogram",
+                "",
+                "readonly",
+                "",
+                "external",
+                "configure");
+
+    addProperty(ShortOutputGain,
+                32767.0,
+                "ShortOutputGain",
+                "",
+                "readwrite",
+                "",
+                "external",
+                "configure");
+
+    addProperty(ShortOutputAGC,
+                false,
+                "ShortOutputAGC",
+                "",
+                "readwrite",
+                "",
+                "external",
+                "configure");
+
+    addProperty(ShortOutputSaturations,
+                0,
+                "ShortOutputSaturations",
+                "",
+                "readonly",
+                "",
+                "external",
+                "configure");
+
+    addProperty(TelemetryEnabled,
+                false,
+                "TelemetryEnabled",
+                "",
+                "readwrite",
+                "",
+                "external",
+                "configure");
+
+    addProperty(telemetry,
+                telemetry_struct(),
+                "telemetry",
+                "",
+                "readonly",
+                "",
+                "external",
+                "configure");
+
+    addProperty(channels,
+                "channels",
+                "",
+                "readwrite",
+                "",
+                "external",
+                "configure");
+
 }
 
 
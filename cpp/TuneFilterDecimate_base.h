@@ -51,12 +51,45 @@ class TuneFilterDecimate_base : public Resource_impl, protected ThreadedComponen
         double InputRF;
         double InputRate;
         CORBA::ULong DecimationFactor;
+        bool RationalResampling;
+        double ResampleTolerance;
+        CORBA::ULong InterpolationFactor;
         CORBA::ULong taps;
         filterProps_struct filterProps;
+        bool AutoFFTSize;
+        std::string FilterEngine;
+        std::string ActiveFilterEngine;
+        double FilterCost;
+        CORBA::ULong PartitionSize;
+        CORBA::ULong FilterLatency;
+        double FilterLatencyTime;
+        CORBA::ULong WorkerThreads;
+        CORBA::ULong PipelineThreads;
+        std::string PipelineCPUs;
+        float PacketTimeout;
+        bool UseStreamAPI;
+        double BytesPerSample;
+        std::string DecimationStages;
+        CORBA::ULong DesignCacheSize;
+        CORBA::ULong DesignCacheHits;
+        CORBA::ULong DesignCacheMisses;
+        std::string FFTWWisdomFile;
+        CORBA::ULong OutputBuffers;
+        double OutputBufferReuse;
+        std::vector<CORBA::ULong> LatencyHistogram;
+        float ShortOutputGain;
+        bool ShortOutputAGC;
+        CORBA::ULong ShortOutputSaturations;
+        bool TelemetryEnabled;
+        telemetry_struct telemetry;
+        std::vector<channel_struct> channels;
 
         // Ports
         bulkio::InFloatPort *dataFloat_in;
+        bulkio::InShortPort *dataShort_in;
+        bulkio::InOctetPort *dataOctet_in;
         bulkio::OutFloatPort *dataFloat_out;
+        bulkio::OutShortPort *dataShort_out;
 
     private:
 };
@@ -0,0 +1,93 @@
+/*
+ * This file is protected by Copyright. Please refer to the COPYRIGHT file distributed with this
+ * source distribution.
+ *
+ * This file is part of REDHAWK Basic Components TuneFilterDecimate.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this
+ * program.  If not, see http://www.gnu.org/licenses/.
+ */
+
+// Compares the Mixer with the dsp library's Tuner it replaced, which needed
+// the packet converted to complex samples first.  Build with
+// "make MixerBenchmark" and run with an optional number of samples.
+
+#include <cmath>
+#include <complex>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+#include "Mixer.h"
+#include "Tuner.h"
+#include "firfilter.h"
+
+namespace {
+	const double TUNING_NORM = 0.1234567891234;
+	const size_t PACKET_SIZE = 8192;
+
+	double seconds(const boost::posix_time::ptime& start)
+	{
+		return (boost::posix_time::microsec_clock::universal_time() - start).total_microseconds()*1e-6;
+	}
+
+	// Largest distance from exp(-j*2*pi*TUNING_NORM*n) over a run of unit input samples
+	double maxError(const Complex* out, size_t len, size_t first)
+	{
+		double err = 0.0;
+		for (size_t i=0; i < len; i++) {
+			double cycles = fmod(TUNING_NORM*double(first+i), 1.0);
+			std::complex<double> ref = std::polar(1.0, -2.0*M_PI*cycles);
+			err = std::max(err, std::abs(std::complex<double>(out[i].real(), out[i].imag()) - ref));
+		}
+		return err;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	const size_t numSamples = (argc > 1) ? strtoul(argv[1], NULL, 10) : 100*1000*1000;
+	const size_t numPackets = std::max(numSamples/PACKET_SIZE, size_t(1));
+
+	// Interleaved I/Q of all ones, so the output is the oscillator itself
+	std::vector<float> packet(2*PACKET_SIZE, 0.0f);
+	for (size_t i=0; i < PACKET_SIZE; i++)
+		packet[2*i] = 1.0f;
+
+	// The Tuner, fed the way the component used to: convert the packet, then mix
+	ComplexVector tunerInput(PACKET_SIZE);
+	firfilter::complexVector tunerOutput(PACKET_SIZE);
+	Tuner tuner(tunerInput, tunerOutput, TUNING_NORM);
+	boost::posix_time::ptime start = boost::posix_time::microsec_clock::universal_time();
+	for (size_t n=0; n < numPackets; n++) {
+		for (size_t i=0; i < PACKET_SIZE; i++)
+			tunerInput[i] = Complex(packet[2*i], packet[2*i+1]);
+		tuner.run();
+	}
+	double tunerTime = seconds(start);
+	double tunerError = maxError(&tunerOutput[0], PACKET_SIZE, (numPackets-1)*PACKET_SIZE);
+
+	// The Mixer, straight from the packet
+	Mixer mixer(TUNING_NORM);
+	ComplexVector mixerOutput(PACKET_SIZE);
+	start = boost::posix_time::microsec_clock::universal_time();
+	for (size_t n=0; n < numPackets; n++)
+		mixer.run(&packet[0], PACKET_SIZE, true, &mixerOutput[0]);
+	double mixerTime = seconds(start);
+	double mixerError = maxError(&mixerOutput[0], PACKET_SIZE, (numPackets-1)*PACKET_SIZE);
+
+	const double total = double(numPackets)*PACKET_SIZE;
+	printf("%g samples, tuning %.13f\n", total, TUNING_NORM);
+	printf("Tuner:        %8.1f Msamples/s   error in last packet %.3g\n", total/tunerTime*1e-6, tunerError);
+	printf("Mixer (%s): %8.1f Msamples/s   error in last packet %.3g\n", mixer.getKernelName(), total/mixerTime*1e-6, mixerError);
+	return 0;
+}
@@ -0,0 +1,217 @@
+/*
+ * This file is protected by Copyright. Please refer to the COPYRIGHT file distributed with this
+ * source distribution.
+ *
+ * This file is part of REDHAWK Basic Components TuneFilterDecimate.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this
+ * program.  If not, see http://www.gnu.org/licenses/.
+ */
+// Throughput of the tune, filter and decimate engine over a sweep of
+// configurations, without REDHAWK.  Build with "make tfd_bench".  Prints
+// one CSV line per configuration; run with --help for the sweep options.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+#include "TfdEngine.h"
+
+namespace {
+	struct Sweep
+	{
+		std::vector<double> inputRates;
+		std::vector<double> filterBWs;      // fraction of the output rate
+		std::vector<double> decimations;
+		std::vector<double> fftSizes;
+		std::vector<double> packetSizes;
+		std::vector<std::string> inputs;    // "complex" and/or "real"
+		std::vector<std::string> engines;
+		std::vector<double> partitionSizes; // PartitionSize, only swept for PARTITIONED
+		double transitionWidth;             // fraction of the output rate
+		double ripple;
+		double seconds;                     // per configuration
+	};
+
+	std::vector<double> parseNumbers(const char* arg)
+	{
+		std::vector<double> values;
+		for (const char* p = arg; *p; ) {
+			char* end;
+			values.push_back(strtod(p, &end));
+			if (end == p)
+				break;
+			p = (*end == ',') ? end+1 : end;
+		}
+		return values;
+	}
+
+	std::vector<std::string> parseStrings(const char* arg)
+	{
+		std::vector<std::string> values;
+		std::string all(arg);
+		for (size_t start = 0; start <= all.size(); ) {
+			size_t comma = all.find(',', start);
+			if (comma == std::string::npos)
+				comma = all.size();
+			if (comma > start)
+				values.push_back(all.substr(start, comma-start));
+			start = comma+1;
+		}
+		return values;
+	}
+
+	double seconds(const boost::posix_time::ptime& start)
+	{
+		return (boost::posix_time::microsec_clock::universal_time() - start).total_microseconds()*1e-6;
+	}
+
+	void usage(const char* name)
+	{
+		printf("usage: %s [options], every list comma separated\n"
+				"  --rate LIST        input sample rates in samples/s (default 1e6,10e6)\n"
+				"  --bw LIST          FilterBW as a fraction of the output rate (default 0.8)\n"
+				"  --decimation LIST  decimation factors (default 2,10,100)\n"
+				"  --fft LIST         FFT_size, 0 to pick it like AutoFFTSize (default 128,4096)\n"
+				"  --packet LIST      samples per packet (default 1024,16384)\n"
+				"  --input LIST       complex and/or real (default complex,real)\n"
+				"  --engine LIST      FilterEngine values (default FFT,POLYPHASE,FUSED,BANDPASS,MULTISTAGE,PARTITIONED,AUTO)\n"
+				"  --partition LIST   PartitionSize of the PARTITIONED engine (default 256,1024)\n"
+				"  --tw FRACTION      TransitionWidth as a fraction of the output rate (default 0.1)\n"
+				"  --ripple VALUE     filter ripple (default 0.01)\n"
+				"  --seconds VALUE    time spent on each configuration (default 0.2)\n", name);
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	Sweep sweep;
+	sweep.inputRates = parseNumbers("1e6,10e6");
+	sweep.filterBWs = parseNumbers("0.8");
+	sweep.decimations = parseNumbers("2,10,100");
+	sweep.fftSizes = parseNumbers("128,4096");
+	sweep.packetSizes = parseNumbers("1024,16384");
+	sweep.inputs = parseStrings("complex,real");
+	sweep.engines = parseStrings("FFT,POLYPHASE,FUSED,BANDPASS,MULTISTAGE,PARTITIONED,AUTO");
+	sweep.partitionSizes = parseNumbers("256,1024");
+	sweep.transitionWidth = 0.1;
+	sweep.ripple = 0.01;
+	sweep.seconds = 0.2;
+
+	for (int i=1; i < argc; i++) {
+		const char* option = argv[i];
+		const char* value = (i+1 < argc) ? argv[i+1] : NULL;
+		if (!strcmp(option, "--help") || !value) {
+			usage(argv[0]);
+			return strcmp(option, "--help") ? 1 : 0;
+		}
+		if (!strcmp(option, "--rate"))
+			sweep.inputRates = parseNumbers(value);
+		else if (!strcmp(option, "--bw"))
+			sweep.filterBWs = parseNumbers(value);
+		else if (!strcmp(option, "--decimation"))
+			sweep.decimations = parseNumbers(value);
+		else if (!strcmp(option, "--fft"))
+			sweep.fftSizes = parseNumbers(value);
+		else if (!strcmp(option, "--packet"))
+			sweep.packetSizes = parseNumbers(value);
+		else if (!strcmp(option, "--input"))
+			sweep.inputs = parseStrings(value);
+		else if (!strcmp(option, "--engine"))
+			sweep.engines = parseStrings(value);
+		else if (!strcmp(option, "--partition"))
+			sweep.partitionSizes = parseNumbers(value);
+		else if (!strcmp(option, "--tw"))
+			sweep.transitionWidth = strtod(value, NULL);
+		else if (!strcmp(option, "--ripple"))
+			sweep.ripple = strtod(value, NULL);
+		else if (!strcmp(option, "--seconds"))
+			sweep.seconds = strtod(value, NULL);
+		else {
+			usage(argv[0]);
+			return 1;
+		}
+		i++;
+	}
+
+	FilterChainBuilder builder;
+	builder.calibrate();
+	TfdEngine engine(builder);
+	std::vector<ComplexVector> output;
+
+	printf("engine,active_engine,input_rate,filter_bw,decimation,fft_size,partition_size,packet_size,input,taps,stages,"
+			"latency_samples,latency_s,estimated_ns_per_sample,msamples_per_s,ns_per_sample\n");
+	for (size_t r=0; r < sweep.inputRates.size(); r++)
+	for (size_t d=0; d < sweep.decimations.size(); d++)
+	for (size_t b=0; b < sweep.filterBWs.size(); b++)
+	for (size_t f=0; f < sweep.fftSizes.size(); f++)
+	for (size_t p=0; p < sweep.packetSizes.size(); p++)
+	for (size_t in=0; in < sweep.inputs.size(); in++)
+	for (size_t e=0; e < sweep.engines.size(); e++)
+	for (size_t pt=0; pt < sweep.partitionSizes.size(); pt++) {
+		// The other engines do not depend on the partition size
+		if ((pt > 0) && (sweep.engines[e] != "PARTITIONED"))
+			continue;
+		const double inputRate = sweep.inputRates[r];
+		const double outputRate = inputRate/std::max(sweep.decimations[d], 1.0);
+		const size_t packetSize = size_t(sweep.packetSizes[p]);
+		const bool complexInput = (sweep.inputs[in] != "real");
+
+		// Tuned a little off centre, as the component would be
+		FilterDesign design;
+		design.engine = sweep.engines[e];
+		design.inputRate = inputRate;
+		design.inputComplex = complexInput;
+		design.decimation = FilterDesign::decimationFor(inputRate, outputRate);
+		design.ripple = sweep.ripple;
+		design.fftSize = size_t(sweep.fftSizes[f]);
+		design.autoFftSize = (design.fftSize == 0);
+		design.partitionSize = size_t(sweep.partitionSizes[pt]);
+		design.tuningNorm = complexInput ? 0.01 : 0.26;
+		design.setPassband(sweep.filterBWs[b]*outputRate, sweep.transitionWidth*outputRate);
+		engine.configure(design);
+		const FilterChain& chain = engine.getChain();
+
+		// Uniform noise, so that nothing is faster for being zero
+		std::vector<float> packet((complexInput ? 2 : 1)*packetSize);
+		for (size_t i=0; i < packet.size(); i++)
+			packet[i] = float(rand())/RAND_MAX - 0.5f;
+		InputSamples input(&packet[0], packetSize, complexInput);
+
+		// One packet to warm up, then as many as fit in the time
+		engine.process(input, output);
+		double processed = 0.0;
+		double elapsed = 0.0;
+		boost::posix_time::ptime start = boost::posix_time::microsec_clock::universal_time();
+		do {
+			for (size_t n=0; n < 16; n++)
+				engine.process(input, output);
+			processed += 16.0*packetSize;
+			elapsed = seconds(start);
+		} while (elapsed < sweep.seconds);
+
+		const size_t latency = chain.latency();
+		printf("%s,%s,%g,%g,%lu,%lu,%lu,%lu,%s,%lu,%s,%lu,%g,%.3f,%.3f,%.3f\n",
+				design.engine.c_str(), chain.engine.c_str(), inputRate, sweep.filterBWs[b]*outputRate,
+				(unsigned long)design.decimation, (unsigned long)chain.fftSize,
+				(chain.partitioned != NULL) ? (unsigned long)chain.partitioned->getBlockSize() : 0UL,
+				(unsigned long)packetSize, complexInput ? "complex" : "real", (unsigned long)chain.numTaps,
+				chain.stages.c_str(), (unsigned long)latency, latency/inputRate,
+				chain.costPerSample, processed/elapsed*1e-6, elapsed/processed*1e9);
+		fflush(stdout);
+	}
+	return 0;
+}
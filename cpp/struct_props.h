@@ -86,5 +86,270 @@ inline bool operator!= (const filterProps_struct& s1, const filterProps_struct&
     return !(s1==s2);
 };
 
+struct channel_struct {
+    channel_struct ()
+    {
+        TuningIF = 0;
+        FilterBW = 8000;
+        DesiredOutputRate = 10000;
+    };
+
+    static std::string getId() {
+        return std::string("channel");
+    };
+
+    double TuningIF;
+    float FilterBW;
+    float DesiredOutputRate;
+};
+
+inline bool operator>>= (const CORBA::Any& a, channel_struct& s) {
+    CF::Properties* temp;
+    if (!(a >>= temp)) return false;
+    CF::Properties& props = *temp;
+    for (unsigned int idx = 0; idx < props.length(); idx++) {
+        if (!strcmp("channel::TuningIF", props[idx].id)) {
+            if (!(props[idx].value >>= s.TuningIF)) return false;
+        }
+        else if (!strcmp("channel::FilterBW", props[idx].id)) {
+            if (!(props[idx].value >>= s.FilterBW)) return false;
+        }
+        else if (!strcmp("channel::DesiredOutputRate", props[idx].id)) {
+            if (!(props[idx].value >>= s.DesiredOutputRate)) return false;
+        }
+    }
+    return true;
+};
+
+inline void operator<<= (CORBA::Any& a, const channel_struct& s) {
+    CF::Properties props;
+    props.length(3);
+    props[0].id = CORBA::string_dup("channel::TuningIF");
+    props[0].value <<= s.TuningIF;
+    props[1].id = CORBA::string_dup("channel::FilterBW");
+    props[1].value <<= s.FilterBW;
+    props[2].id = CORBA::string_dup("channel::DesiredOutputRate");
+    props[2].value <<= s.DesiredOutputRate;
+    a <<= props;
+};
+
+inline bool operator== (const channel_struct& s1, const channel_struct& s2) {
+    if (s1.TuningIF!=s2.TuningIF)
+        return false;
+    if (s1.FilterBW!=s2.FilterBW)
+        return false;
+    if (s1.DesiredOutputRate!=s2.DesiredOutputRate)
+        return false;
+    return true;
+};
+
+inline bool operator!= (const channel_struct& s1, const channel_struct& s2) {
+    return !(s1==s2);
+};
+
+struct telemetry_struct {
+    telemetry_struct ()
+    {
+        Packets = 0;
+        Samples = 0;
+        DroppedPackets = 0;
+        QueueFlushes = 0;
+        Rebuilds = 0;
+        SRIKeywordChanges = 0;
+        SRIRFChanges = 0;
+        SRIModeChanges = 0;
+        SRIRateChanges = 0;
+        LastRebuildTime = 0;
+        TotalRebuildTime = 0;
+        PrepareTime = 0;
+        TuneTime = 0;
+        FilterTime = 0;
+        PushTime = 0;
+        PrepareTimeWindow = 0;
+        TuneTimeWindow = 0;
+        FilterTimeWindow = 0;
+        PushTimeWindow = 0;
+    };
+
+    static std::string getId() {
+        return std::string("telemetry");
+    };
+
+    CORBA::ULongLong Packets;
+    CORBA::ULongLong Samples;
+    CORBA::ULong DroppedPackets;
+    CORBA::ULong QueueFlushes;
+    CORBA::ULong Rebuilds;
+    CORBA::ULong SRIKeywordChanges;
+    CORBA::ULong SRIRFChanges;
+    CORBA::ULong SRIModeChanges;
+    CORBA::ULong SRIRateChanges;
+    double LastRebuildTime;
+    double TotalRebuildTime;
+    double PrepareTime;
+    double TuneTime;
+    double FilterTime;
+    double PushTime;
+    double PrepareTimeWindow;
+    double TuneTimeWindow;
+    double FilterTimeWindow;
+    double PushTimeWindow;
+};
+
+inline bool operator>>= (const CORBA::Any& a, telemetry_struct& s) {
+    CF::Properties* temp;
+    if (!(a >>= temp)) return false;
+    CF::Properties& props = *temp;
+    for (unsigned int idx = 0; idx < props.length(); idx++) {
+        if (!strcmp("telemetry::Packets", props[idx].id)) {
+            if (!(props[idx].value >>= s.Packets)) return false;
+        }
+        else if (!strcmp("telemetry::Samples", props[idx].id)) {
+            if (!(props[idx].value >>= s.Samples)) return false;
+        }
+        else if (!strcmp("telemetry::DroppedPackets", props[idx].id)) {
+            if (!(props[idx].value >>= s.DroppedPackets)) return false;
+        }
+        else if (!strcmp("telemetry::QueueFlushes", props[idx].id)) {
+            if (!(props[idx].value >>= s.QueueFlushes)) return false;
+        }
+        else if (!strcmp("telemetry::Rebuilds", props[idx].id)) {
+            if (!(props[idx].value >>= s.Rebuilds)) return false;
+        }
+        else if (!strcmp("telemetry::SRIKeywordChanges", props[idx].id)) {
+            if (!(props[idx].value >>= s.SRIKeywordChanges)) return false;
+        }
+        else if (!strcmp("telemetry::SRIRFChanges", props[idx].id)) {
+            if (!(props[idx].value >>= s.SRIRFChanges)) return false;
+        }
+        else if (!strcmp("telemetry::SRIModeChanges", props[idx].id)) {
+            if (!(props[idx].value >>= s.SRIModeChanges)) return false;
+        }
+        else if (!strcmp("telemetry::SRIRateChanges", props[idx].id)) {
+            if (!(props[idx].value >>= s.SRIRateChanges)) return false;
+        }
+        else if (!strcmp("telemetry::LastRebuildTime", props[idx].id)) {
+            if (!(props[idx].value >>= s.LastRebuildTime)) return false;
+        }
+        else if (!strcmp("telemetry::TotalRebuildTime", props[idx].id)) {
+            if (!(props[idx].value >>= s.TotalRebuildTime)) return false;
+        }
+        else if (!strcmp("telemetry::PrepareTime", props[idx].id)) {
+            if (!(props[idx].value >>= s.PrepareTime)) return false;
+        }
+        else if (!strcmp("telemetry::TuneTime", props[idx].id)) {
+            if (!(props[idx].value >>= s.TuneTime)) return false;
+        }
+        else if (!strcmp("telemetry::FilterTime", props[idx].id)) {
+            if (!(props[idx].value >>= s.FilterTime)) return false;
+        }
+        else if (!strcmp("telemetry::PushTime", props[idx].id)) {
+            if (!(props[idx].value >>= s.PushTime)) return false;
+        }
+        else if (!strcmp("telemetry::PrepareTimeWindow", props[idx].id)) {
+            if (!(props[idx].value >>= s.PrepareTimeWindow)) return false;
+        }
+        else if (!strcmp("telemetry::TuneTimeWindow", props[idx].id)) {
+            if (!(props[idx].value >>= s.TuneTimeWindow)) return false;
+        }
+        else if (!strcmp("telemetry::FilterTimeWindow", props[idx].id)) {
+            if (!(props[idx].value >>= s.FilterTimeWindow)) return false;
+        }
+        else if (!strcmp("telemetry::PushTimeWindow", props[idx].id)) {
+            if (!(props[idx].value >>= s.PushTimeWindow)) return false;
+        }
+    }
+    return true;
+};
+
+inline void operator<<= (CORBA::Any& a, const telemetry_struct& s) {
+    CF::Properties props;
+    props.length(19);
+    props[0].id = CORBA::string_dup("telemetry::Packets");
+    props[0].value <<= s.Packets;
+    props[1].id = CORBA::string_dup("telemetry::Samples");
+    props[1].value <<= s.Samples;
+    props[2].id = CORBA::string_dup("telemetry::DroppedPackets");
+    props[2].value <<= s.DroppedPackets;
+    props[3].id = CORBA::string_dup("telemetry::QueueFlushes");
+    props[3].value <<= s.QueueFlushes;
+    props[4].id = CORBA::string_dup("telemetry::Rebuilds");
+    props[4].value <<= s.Rebuilds;
+    props[5].id = CORBA::string_dup("telemetry::SRIKeywordChanges");
+    props[5].value <<= s.SRIKeywordChanges;
+    props[6].id = CORBA::string_dup("telemetry::SRIRFChanges");
+    props[6].value <<= s.SRIRFChanges;
+    props[7].id = CORBA::string_dup("telemetry::SRIModeChanges");
+    props[7].value <<= s.SRIModeChanges;
+    props[8].id = CORBA::string_dup("telemetry::SRIRateChanges");
+    props[8].value <<= s.SRIRateChanges;
+    props[9].id = CORBA::string_dup("telemetry::LastRebuildTime");
+    props[9].value <<= s.LastRebuildTime;
+    props[10].id = CORBA::string_dup("telemetry::TotalRebuildTime");
+    props[10].value <<= s.TotalRebuildTime;
+    props[11].id = CORBA::string_dup("telemetry::PrepareTime");
+    props[11].value <<= s.PrepareTime;
+    props[12].id = CORBA::string_dup("telemetry::TuneTime");
+    props[12].value <<= s.TuneTime;
+    props[13].id = CORBA::string_dup("telemetry::FilterTime");
+    props[13].value <<= s.FilterTime;
+    props[14].id = CORBA::string_dup("telemetry::PushTime");
+    props[14].value <<= s.PushTime;
+    props[15].id = CORBA::string_dup("telemetry::PrepareTimeWindow");
+    props[15].value <<= s.PrepareTimeWindow;
+    props[16].id = CORBA::string_dup("telemetry::TuneTimeWindow");
+    props[16].value <<= s.TuneTimeWindow;
+    props[17].id = CORBA::string_dup("telemetry::FilterTimeWindow");
+    props[17].value <<= s.FilterTimeWindow;
+    props[18].id = CORBA::string_dup("telemetry::PushTimeWindow");
+    props[18].value <<= s.PushTimeWindow;
+    a <<= props;
+};
+
+inline bool operator== (const telemetry_struct& s1, const telemetry_struct& s2) {
+    if (s1.Packets!=s2.Packets)
+        return false;
+    if (s1.Samples!=s2.Samples)
+        return false;
+    if (s1.DroppedPackets!=s2.DroppedPackets)
+        return false;
+    if (s1.QueueFlushes!=s2.QueueFlushes)
+        return false;
+    if (s1.Rebuilds!=s2.Rebuilds)
+        return false;
+    if (s1.SRIKeywordChanges!=s2.SRIKeywordChanges)
+        return false;
+    if (s1.SRIRFChanges!=s2.SRIRFChanges)
+        return false;
+    if (s1.SRIModeChanges!=s2.SRIModeChanges)
+        return false;
+    if (s1.SRIRateChanges!=s2.SRIRateChanges)
+        return false;
+    if (s1.LastRebuildTime!=s2.LastRebuildTime)
+        return false;
+    if (s1.TotalRebuildTime!=s2.TotalRebuildTime)
+        return false;
+    if (s1.PrepareTime!=s2.PrepareTime)
+        return false;
+    if (s1.TuneTime!=s2.TuneTime)
+        return false;
+    if (s1.FilterTime!=s2.FilterTime)
+        return false;
+    if (s1.PushTime!=s2.PushTime)
+        return false;
+    if (s1.PrepareTimeWindow!=s2.PrepareTimeWindow)
+        return false;
+    if (s1.TuneTimeWindow!=s2.TuneTimeWindow)
+        return false;
+    if (s1.FilterTimeWindow!=s2.FilterTimeWindow)
+        return false;
+    if (s1.PushTimeWindow!=s2.PushTimeWindow)
+        return false;
+    return true;
+};
+
+inline bool operator!= (const telemetry_struct& s1, const telemetry_struct& s2) {
+    return !(s1==s2);
+};
 
 #endif // STRUCTPROPS_H
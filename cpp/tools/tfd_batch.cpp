@@ -0,0 +1,184 @@
+/*
+ * This file is protected by Copyright. Please refer to the COPYRIGHT file distributed with this
+ * source distribution.
+ *
+ * This file is part of REDHAWK Basic Components TuneFilterDecimate.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * REDHAWK Basic Components TuneFilterDecimate is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this
+ * program.  If not, see http://www.gnu.org/licenses/.
+ */
+
+// Offline tune, filter and decimate of capture files, with the DSP the
+// component runs, on every core.  Build with "make tfd_batch"; run with
+// --help for the options.  The output is raw interleaved I/Q floats.
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/thread.hpp>
+
+#include "BatchProcessor.h"
+#include "MappedCapture.h"
+
+namespace {
+	void usage(const char* name)
+	{
+		printf("usage: %s [options] INPUT OUTPUT\n"
+				"  --type TYPE        raw input data type: CF, CI, CB, SF, SI or SB (default CF);\n"
+				"                     BLUE files give their own\n"
+				"  --rate HZ          input sample rate, required unless the BLUE header gives it\n"
+				"  --if HZ            frequency to tune to baseband (TuningIF, default 0)\n"
+				"  --output-rate HZ   DesiredOutputRate (default the input rate)\n"
+				"  --bw HZ            FilterBW (default 80%% of the output rate)\n"
+				"  --tw HZ            TransitionWidth (default 10%% of the output rate)\n"
+				"  --ripple VALUE     filter ripple (default 0.01)\n"
+				"  --engine NAME      POLYPHASE, MULTISTAGE, FUSED, BANDPASS or AUTO (default POLYPHASE)\n"
+				"  --threads N        worker threads (default one per core)\n"
+				"  --chunk SAMPLES    input samples per chunk (default 16777216)\n"
+				"  --serial           one pass over the whole file, for comparison\n"
+				"  --wisdom FILE      FFTW wisdom to import\n", name);
+	}
+
+	double seconds(const boost::posix_time::ptime& start)
+	{
+		return (boost::posix_time::microsec_clock::universal_time() - start).total_microseconds()*1e-6;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	std::string type = "CF";
+	double inputRate = 0.0;
+	double tuningIF = 0.0;
+	double outputRate = 0.0;
+	double filterBW = 0.0;
+	double transitionWidth = 0.0;
+	double ripple = 0.01;
+	std::string engine = "POLYPHASE";
+	size_t numThreads = std::max(boost::thread::hardware_concurrency(), 1u);
+	size_t chunkSize = 16*1024*1024;
+	std::string wisdom;
+	std::vector<std::string> files;
+
+	for (int i=1; i < argc; i++) {
+		const char* option = argv[i];
+		if (!strcmp(option, "--help")) {
+			usage(argv[0]);
+			return 0;
+		} else if (!strcmp(option, "--serial")) {
+			numThreads = 1;
+			chunkSize = 0;
+			continue;
+		} else if (strncmp(option, "--", 2)) {
+			files.push_back(option);
+			continue;
+		}
+		if (i+1 == argc) {
+			usage(argv[0]);
+			return 1;
+		}
+		const char* value = argv[++i];
+		if (!strcmp(option, "--type"))
+			type = value;
+		else if (!strcmp(option, "--rate"))
+			inputRate = strtod(value, NULL);
+		else if (!strcmp(option, "--if"))
+			tuningIF = strtod(value, NULL);
+		else if (!strcmp(option, "--output-rate"))
+			outputRate = strtod(value, NULL);
+		else if (!strcmp(option, "--bw"))
+			filterBW = strtod(value, NULL);
+		else if (!strcmp(option, "--tw"))
+			transitionWidth = strtod(value, NULL);
+		else if (!strcmp(option, "--ripple"))
+			ripple = strtod(value, NULL);
+		else if (!strcmp(option, "--engine"))
+			engine = value;
+		else if (!strcmp(option, "--threads"))
+			numThreads = strtoul(value, NULL, 10);
+		else if (!strcmp(option, "--chunk"))
+			chunkSize = strtoul(value, NULL, 10);
+		else if (!strcmp(option, "--wisdom"))
+			wisdom = value;
+		else {
+			usage(argv[0]);
+			return 1;
+		}
+	}
+	if (files.size() != 2) {
+		usage(argv[0]);
+		return 1;
+	}
+
+	MappedCapture capture;
+	if (!capture.open(files[0], type)) {
+		fprintf(stderr, "%s\n", capture.getError().c_str());
+		return 1;
+	}
+	if (capture.getSampleRate() > 0)
+		inputRate = capture.getSampleRate();
+	if (inputRate <= 0) {
+		fprintf(stderr, "%s: no sample rate, use --rate\n", files[0].c_str());
+		return 1;
+	}
+	if (outputRate <= 0)
+		outputRate = inputRate;
+
+	// The same design the component makes from its properties
+	FilterDesign design;
+	design.engine = engine;
+	design.inputRate = inputRate;
+	design.inputComplex = capture.isComplex();
+	design.decimation = FilterDesign::decimationFor(inputRate, outputRate);
+	design.ripple = ripple;
+	design.tuningNorm = tuningIF/inputRate;
+	const double decimatedRate = inputRate/design.decimation;
+	if (!design.setPassband((filterBW > 0) ? filterBW : 0.8*decimatedRate,
+			(transitionWidth > 0) ? transitionWidth : 0.1*decimatedRate))
+		fprintf(stderr, "transition width reduced to %g Hz to avoid aliasing\n", design.transitionWidth);
+
+	FilterChainBuilder builder;
+	if (!wisdom.empty() && !builder.importWisdom(wisdom))
+		fprintf(stderr, "%s: could not import FFTW wisdom\n", wisdom.c_str());
+	BatchProcessor processor(builder, design);
+	if (!processor.prepare()) {
+		fprintf(stderr, "%s\n", processor.getError().c_str());
+		return 1;
+	}
+
+	FILE* output = fopen(files[1].c_str(), "wb");
+	if (output == NULL) {
+		perror(files[1].c_str());
+		return 1;
+	}
+	boost::posix_time::ptime start = boost::posix_time::microsec_clock::universal_time();
+	bool ok = processor.run(capture, output, numThreads, chunkSize);
+	ok = (fclose(output) == 0) && ok;
+	const double elapsed = seconds(start);
+	if (!ok) {
+		fprintf(stderr, "%s: %s\n", files[1].c_str(), processor.getError().empty() ? "write failed" : processor.getError().c_str());
+		return 1;
+	}
+
+	fprintf(stderr, "%s engine, %lu taps, decimation %lu, output rate %.6f Hz\n",
+			processor.getEngine().c_str(), (unsigned long)processor.getNumTaps(),
+			(unsigned long)processor.getDecimation(), inputRate/processor.getDecimation());
+	if (!processor.getStages().empty())
+		fprintf(stderr, "stages %s\n", processor.getStages().c_str());
+	fprintf(stderr, "%lu samples in, %llu out in %.3f s (%.1f Msps) on %lu threads\n",
+			(unsigned long)capture.getNumSamples(), (unsigned long long)processor.getOutputSamples(),
+			elapsed, capture.getNumSamples()/elapsed*1e-6, (unsigned long)numThreads);
+	return 0;
+}
@@ -109,6 +109,50 @@ class ComponentTests(ossie.utils.testing.ScaComponentTestCase):
             self.comp.configure(myProps)
             print self.comp.query([])
 
+    def pushAndDrain(self, sig, sampleRate, streamID, pktSize=8192, src=None, eachPacket=None):
+        """Push sig as complex data in packets of pktSize, with EOS on the last one, and return the
+           interleaved output once the sink sees EOS.  eachPacket(i, numPushes) is called before
+           packet i is pushed, and may return extra keyword arguments for that push.
+        """
+        if src is None:
+            src = self.src
+        numPushes = (len(sig)+pktSize-1)/pktSize
+        for i in xrange(numPushes):
+            extra = eachPacket(i, numPushes) if eachPacket else None
+            src.push(sig[i*pktSize:(i+1)*pktSize],
+                     streamID=streamID,
+                     complexData=True,
+                     sampleRate=sampleRate,
+                     EOS=(i==numPushes-1),
+                     **(extra or {}))
+        out = []
+        count = 0
+        while not self.sink.eos() and count < 500:
+            out.extend(self.sink.getData())
+            time.sleep(.01)
+            count += 1
+        out.extend(self.sink.getData())
+        return out
+
+    def runEngine(self, sig, sampleRate, engine, streamID, **kwargs):
+        """Run sig through main() as a new stream, with FilterEngine set to engine unless it is None,
+           after clearing what the source and the sink kept of earlier streams.  The output size is
+           only checked when checkOutputSize is passed.
+        """
+        self.src.reset()
+        self.sink.reset()
+        if engine is not None:
+            self.comp.FilterEngine = engine
+        kwargs.setdefault('checkOutputSize', False)
+        return self.main(sig, sampleRate, streamID=streamID, **kwargs)
+
+    def assertOutputsAgree(self, outA, outB, places=3):
+        """Compare two complex outputs sample by sample, as far as the shorter one goes
+        """
+        for a, b in zip(outA, outB):
+            self.assertAlmostEqual(a.real, b.real, places)
+            self.assertAlmostEqual(a.imag, b.imag, places)
+
     def setUp(self):
         """Set up the unit test - this is run before every method that starts with test
         """
@@ -779,6 +823,549 @@ class ComponentTests(ossie.utils.testing.ScaComponentTestCase):
         print self.comp.api()
 
 
+    def testPolyphaseEngine(self):
+        """Run the same signal through the FFT engine and the polyphase engine and verify the outputs agree
+        """
+        fs = 100e3
+        sig = [random.random()-.5 for _ in xrange(2*256*1024)]
+        self.comp.TuneMode = "IF"
+        self.comp.TuningIF = 12.5e3
+        self.comp.FilterBW = 4e3
+        self.comp.DesiredOutputRate = 5e3
+
+        outFft = self.runEngine(sig, fs, "FFT", "tfd-stream-fft", checkOutputSize=True)
+        outPoly = self.runEngine(sig, fs, "POLYPHASE", "tfd-stream-poly")
+
+        # the polyphase engine has no FFT block latency so it can only produce more output
+        self.assertTrue(len(outPoly) >= len(outFft))
+        self.assertEqual(len(outPoly), int(math.ceil(len(sig)/2/float(self.comp.DecimationFactor))))
+        self.assertOutputsAgree(outFft, outPoly)
+
+    def testFusedEngine(self):
+        """Verify the fused kernel matches the polyphase engine and moves less memory per sample
+        """
+        fs = 100e3
+        sig = genSinWave(fs, 12.7e3, 256*1024)
+        self.comp.TuneMode = "IF"
+        self.comp.TuningIF = 12.5e3
+        self.comp.FilterBW = 4e3
+        self.comp.DesiredOutputRate = 5e3
+
+        outPoly = self.runEngine(sig, fs, "POLYPHASE", "tfd-stream-poly")
+        polyBytes = self.comp.BytesPerSample
+        outFused = self.runEngine(sig, fs, "FUSED", "tfd-stream-fused")
+        self.assertTrue(self.comp.BytesPerSample < polyBytes)
+
+        self.assertEqual(len(outPoly), len(outFused))
+        self.assertOutputsAgree(outPoly, outFused)
+
+    def testInterleavedStreams(self):
+        """Push two streams at the same time and verify neither one is dropped
+        """
+        inpRate = 100e3
+        sig = [random.random()-.5 for _ in xrange(2*64*1024)]
+        self.comp.TuneMode = "IF"
+        self.comp.TuningIF = 10e3
+        self.comp.FilterBW = 8e3
+        self.comp.DesiredOutputRate = 10e3
+
+        outSingle = self.main(sig, inpRate, streamID="tfd-stream-single")
+        self.src.reset()
+        self.sink.reset()
+
+        pktSize = 8192
+        numPushes = (len(sig)+pktSize-1)/pktSize
+        for i in xrange(numPushes):
+            for streamID in ("tfd-stream-A", "tfd-stream-B"):
+                self.src.push(sig[i*pktSize:(i+1)*pktSize],
+                              streamID=streamID,
+                              complexData=True,
+                              sampleRate=inpRate,
+                              EOS=(i==numPushes-1))
+        out = []
+        count = 0
+        while len(out) < 4*len(outSingle) and count < 200:
+            newOut = self.sink.getData()
+            if newOut:
+                out.extend(newOut)
+                count = 0
+            time.sleep(.01)
+            count += 1
+        # both streams are processed independently, so the sink sees twice the output of a single stream
+        self.assertEqual(len(out), 4*len(outSingle))
+
+    def testMultistageEngine(self):
+        """Decimate by 1000 with the multistage engine and verify it passes a tone like the single stage design
+        """
+        fs = 1e6
+        sig = genSinWave(fs, 100e3+50, 1024*1024)
+        self.comp.TuneMode = "IF"
+        self.comp.TuningIF = 100e3
+        self.setProps(FilterBW=400, DesiredOutputRate=1e3, filterProps=[8192,100,0.01])
+
+        outSingle = self.runEngine(sig, fs, "POLYPHASE", "tfd-stream-single")
+        singleTaps = self.comp.taps
+        outMulti = self.runEngine(sig, fs, "MULTISTAGE", "tfd-stream-multi")
+        self.assertEqual(self.comp.DecimationFactor, 1000)
+        self.assertTrue('x' in self.comp.DecimationStages)
+        self.assertTrue(self.comp.taps < singleTaps/4)
+
+        self.assertEqual(len(outSingle), len(outMulti))
+        # skip the filter transients, then both should pass the 50 Hz tone at unity gain
+        for a, b in zip(outSingle[-500:], outMulti[-500:]):
+            self.assertAlmostEqual(abs(a), 1.0, 1)
+            self.assertAlmostEqual(abs(b), 1.0, 1)
+
+    def testDesignCache(self):
+        """Verify a second stream with the same configuration reuses the cached filter design
+        """
+        fs = 100e3
+        sig = [random.random()-.5 for _ in xrange(2*64*1024)]
+        self.comp.TuneMode = "IF"
+        self.comp.TuningIF = 10e3
+        self.comp.FilterBW = 8e3
+        self.comp.DesiredOutputRate = 10e3
+
+        outA = self.main(sig, fs, streamID="tfd-stream-A")
+        misses = self.comp.DesignCacheMisses
+        hits = self.comp.DesignCacheHits
+        self.assertTrue(misses >= 1)
+        self.src.reset()
+        self.sink.reset()
+
+        outB = self.main(sig, fs, streamID="tfd-stream-B")
+        self.assertEqual(self.comp.DesignCacheMisses, misses)
+        self.assertTrue(self.comp.DesignCacheHits > hits)
+        self.assertEqual(len(outA), len(outB))
+
+    def testRebuildWithoutTransient(self):
+        """Change the filter bandwidth in the middle of a stream and verify a tone in the passband is never interrupted
+        """
+        cxOut, numInput = self.rebuildMidStream("POLYPHASE", "tfd-stream-rebuild")
+        self.assertEqual(len(cxOut), int(math.ceil(numInput/20.0)))
+
+    def testRebuildWithoutTransientFFT(self):
+        """Same as testRebuildWithoutTransient with the FFT engine, which switches over with a block of
+           outputs still buffered in the old filter
+        """
+        cxOut, numInput = self.rebuildMidStream("FFT", "tfd-stream-rebuild-fft")
+        # only the outputs still buffered in the last block are missing
+        expected = int(math.ceil(numInput/20.0))
+        self.assertTrue(len(cxOut) <= expected)
+        self.assertTrue(len(cxOut) >= expected - (self.comp.filterProps.FFT_size/20 + 1))
+
+    def testRebuildWithoutTransientFused(self):
+        """Same as testRebuildWithoutTransient with the FUSED engine, which carries its own mixer phase over
+        """
+        cxOut, numInput = self.rebuildMidStream("FUSED", "tfd-stream-rebuild-fused")
+        self.assertEqual(len(cxOut), int(math.ceil(numInput/20.0)))
+
+    def rebuildMidStream(self, engine, streamID):
+        """Narrow the filter halfway through a tone 1 kHz off the tuning frequency, check that no output
+           is lost, repeated or off the decimation grid at the switch, and return the output and the
+           number of input samples
+        """
+        fs = 100e3
+        toneOffset = 1e3
+        outputRate = 5e3
+        sig = genSinWave(fs, 12.5e3+toneOffset, 256*1024)
+        self.comp.TuneMode = "IF"
+        self.comp.TuningIF = 12.5e3
+        self.comp.FilterBW = 4e3
+        self.comp.DesiredOutputRate = outputRate
+        self.comp.FilterEngine = engine
+
+        tapsBefore = []
+        def narrowHalfway(i, numPushes):
+            if i == numPushes/2:
+                count = 0
+                while self.comp.taps == 0 and count < 500:
+                    time.sleep(.01)
+                    count += 1
+                tapsBefore.append(self.comp.taps)
+                self.comp.FilterBW = 3e3
+        out = self.pushAndDrain(sig, fs, streamID, eachPacket=narrowHalfway)
+        self.assertEqual(self.comp.FilterBW, 3e3)
+        self.assertNotEqual(tapsBefore[0], 0)
+
+        # no restart of the filter: every output after the initial transient passes the tone at unity gain
+        cxOut = toCx(out)
+        self.assertTrue(len(cxOut) > 1000)
+        for val in cxOut[100:]:
+            self.assertAlmostEqual(abs(val), 1.0, 1)
+
+        # The phase advances by the same step from one output to the next, except at the switch, where
+        # it also moves by the change in the group delay of the filter, (taps-1)/2 input samples.  An
+        # output lost or repeated, or one input sample off the grid, would show up as another step.
+        def wrap(x):
+            return (x+math.pi) % (2*math.pi) - math.pi
+        step = 2*math.pi*toneOffset/outputRate
+        delayChange = (self.comp.taps - tapsBefore[0])/2.0
+        switchStep = wrap(step - 2*math.pi*toneOffset*delayChange/fs)
+        tail = cxOut[100:]
+        steps = [cmath.phase(b*a.conjugate()) for a, b in zip(tail[:-1], tail[1:])]
+        odd = [s for s in steps if abs(wrap(s-step)) > 0.02]
+        self.assertTrue(len(odd) <= 1)
+        for s in odd:
+            self.assertTrue(abs(wrap(s-switchStep)) < 0.02)
+        return cxOut, len(sig)/2
+
+    def testConfigureWhileStreaming(self):
+        """Retune over and over while data is flowing and verify no data is lost and the last setting wins
+        """
+        fs = 100e3
+        sig = genSinWave(fs, 1e3, 64*1024)
+        self.setProps(TuneMode="IF", TuningIF=0, FilterBW=8e3, DesiredOutputRate=10e3)
+        self.comp.FilterEngine = "POLYPHASE"
+
+        def retune(i, numPushes):
+            # the last setting, before the last packet, is the one that must win
+            self.comp.TuningIF = 1e3*(i%4) if i < numPushes-1 else 1e3
+        out = self.pushAndDrain(sig, fs, "tfd-stream-configure", pktSize=1024, eachPacket=retune)
+
+        # every input sample was processed, and the readbacks follow the last configuration
+        self.assertEqual(len(out)/2, int(math.ceil(len(sig)/2/10.0)))
+        self.assertEqual(self.comp.TuningIF, 1e3)
+        self.assertAlmostEqual(self.comp.TuningNorm, 1e3/fs)
+
+    def testOutputBufferPool(self):
+        """Verify output packets reuse pooled buffers instead of allocating one per packet
+        """
+        fs = 100e3
+        sig = genSinWave(fs, 1e3, 64*1024)
+        self.setProps(TuneMode="IF", TuningIF=0, FilterBW=8e3, DesiredOutputRate=10e3)
+        self.comp.FilterEngine = "POLYPHASE"
+
+        pktSize = 2048
+        numPushes = len(sig)/pktSize
+        out = self.pushAndDrain(sig, fs, "tfd-stream-pool", pktSize=pktSize)
+
+        self.assertEqual(len(out)/2, int(math.ceil(len(sig)/2/10.0)))
+        self.assertTrue(self.comp.OutputBuffers >= 1)
+        self.assertTrue(self.comp.OutputBuffers < numPushes)
+        self.assertTrue(self.comp.OutputBufferReuse > 0.5)
+
+    def testPipelineThreads(self):
+        """Verify the pipelined mode produces the same output as processing on the service thread
+        """
+        fs = 100e3
+        sig = [random.random()-.5 for _ in xrange(2*64*1024)]
+        self.setProps(TuneMode="IF", TuningIF=12.5e3, FilterBW=8e3, DesiredOutputRate=10e3)
+        outDirect = self.runEngine(sig, fs, "POLYPHASE", "tfd-stream-direct", pktSize=2048)
+
+        self.comp.stop()
+        self.comp.PipelineThreads = 3
+        self.comp.start()
+        outPipelined = self.runEngine(sig, fs, None, "tfd-stream-pipelined", pktSize=2048)
+
+        self.assertEqual(len(outDirect), int(math.ceil(len(sig)/2/10.0)))
+        self.assertEqual(len(outPipelined), len(outDirect))
+        self.assertOutputsAgree(outDirect, outPipelined)
+
+    def testPipelineCPUs(self):
+        """Verify the pipeline runs with its threads pinned to a CPU list, and skips entries that are not CPUs
+        """
+        fs = 100e3
+        sig = genSinWave(fs, 1e3, 64*1024)
+        self.setProps(TuneMode="IF", TuningIF=0, FilterBW=8e3, DesiredOutputRate=10e3)
+        self.comp.FilterEngine = "POLYPHASE"
+
+        self.comp.stop()
+        self.comp.PipelineThreads = 3
+        self.comp.PipelineCPUs = "0-1,bogus"
+        self.comp.start()
+        out = self.pushAndDrain(sig, fs, "tfd-stream-cpus", pktSize=2048)
+
+        self.assertEqual(len(out)/2, int(math.ceil(len(sig)/2/10.0)))
+
+    def testStreamAPI(self):
+        """Verify reading the input through the bulkio stream API gives the same output, and the EOS, as getPacket
+        """
+        fs = 100e3
+        sig = [random.random()-.5 for _ in xrange(2*64*1024)]
+        self.setProps(TuneMode="IF", TuningIF=12.5e3, FilterBW=8e3, DesiredOutputRate=10e3)
+        outPacket = self.runEngine(sig, fs, "POLYPHASE", "tfd-stream-packet", pktSize=2048)
+
+        self.comp.stop()
+        self.comp.UseStreamAPI = True
+        self.comp.start()
+        outStream = self.runEngine(sig, fs, None, "tfd-stream-stream", pktSize=2048)
+        self.assertTrue(self.sink.eos())
+
+        self.assertEqual(len(outPacket), int(math.ceil(len(sig)/2/10.0)))
+        self.assertEqual(len(outStream), len(outPacket))
+        self.assertOutputsAgree(outPacket, outStream)
+
+    def testPacketTimeout(self):
+        """Verify packets are picked up while waiting on the queue and counted in the latency histogram
+        """
+        fs = 100e3
+        sig = genSinWave(fs, 1e3, 16*1024)
+        self.setProps(TuneMode="IF", TuningIF=0, FilterBW=8e3, DesiredOutputRate=10e3)
+        self.comp.FilterEngine = "POLYPHASE"
+        self.comp.PacketTimeout = 0.05
+        self.assertEqual(len(self.comp.LatencyHistogram), 24)
+
+        pktSize = 2048
+        numPushes = len(sig)/pktSize
+        def idleGap(i, numPushes):
+            if i > 0:
+                time.sleep(.1) # idle gaps longer than the timeout
+        out = self.pushAndDrain(sig, fs, "tfd-stream-timeout", pktSize=pktSize, eachPacket=idleGap)
+
+        self.assertEqual(len(out)/2, int(math.ceil(len(sig)/2/10.0)))
+        self.assertEqual(sum(self.comp.LatencyHistogram), numPushes)
+
+    def testShortInput(self):
+        """Verify 16-bit input gives the same output as the same samples scaled to float
+        """
+        fs = 100e3
+        sigShort = [int(16000*math.sin(2*math.pi*2e3*i/fs)) for i in xrange(2*32*1024)]
+        sigFloat = [x/32768.0 for x in sigShort]
+        self.setProps(TuneMode="IF", TuningIF=1e3, FilterBW=8e3, DesiredOutputRate=10e3)
+        outFloat = self.runEngine(sigFloat, fs, "POLYPHASE", "tfd-stream-float", pktSize=4096)
+        self.sink.reset()
+
+        srcShort = sb.DataSource(dataFormat="short")
+        srcShort.connect(self.comp, providesPortName="dataShort_in")
+        srcShort.start()
+        out = self.pushAndDrain(sigShort, fs, "tfd-stream-short", pktSize=4096, src=srcShort)
+        srcShort.stop()
+        srcShort.releaseObject()
+
+        outShort = toCx(out)
+        self.assertEqual(len(outShort), len(outFloat))
+        self.assertOutputsAgree(outFloat, outShort, 4)
+
+    def testShortOutput(self):
+        """Verify dataShort_out carries the float output scaled, rounded and saturated to 16 bits
+        """
+        fs = 100e3
+        sig = [.5*math.sin(2*math.pi*2e3*i/fs) for i in xrange(2*32*1024)]
+        self.setProps(TuneMode="IF", TuningIF=1e3, FilterBW=8e3, DesiredOutputRate=10e3)
+        self.comp.FilterEngine = "POLYPHASE"
+        self.comp.ShortOutputGain = 20000.0
+
+        sinkShort = sb.DataSink(dataFormat="short")
+        self.comp.connect(sinkShort, usesPortName="dataShort_out")
+        sinkShort.start()
+        outFloat = self.main(sig, fs, checkOutputSize=False, pktSize=4096, streamID="tfd-stream-short")
+        # each packet goes out on dataFloat_out first, so the last one may still be on its way
+        out = []
+        count = 0
+        while not sinkShort.eos() and count < 200:
+            out.extend(sinkShort.getData())
+            time.sleep(.01)
+            count += 1
+        out.extend(sinkShort.getData())
+        outShort = toCx(out)
+        self.assertEqual(sinkShort.sri().streamID, "tfd-stream-short")
+        self.assertEqual(len(outShort), len(outFloat))
+        for a, b in zip(outFloat, outShort):
+            self.assertTrue(abs(round(a.real*20000.0)-b.real) <= 1)
+            self.assertTrue(abs(round(a.imag*20000.0)-b.imag) <= 1)
+        self.assertEqual(self.comp.ShortOutputSaturations, 0)
+
+        # Too much gain clips, and is counted
+        self.comp.ShortOutputGain = 1e6
+        self.sink.reset()
+        self.main(sig, fs, checkOutputSize=False, pktSize=4096, streamID="tfd-stream-clip")
+        self.assertTrue(self.comp.ShortOutputSaturations > 0)
+        sinkShort.stop()
+        sinkShort.releaseObject()
+
+    def testFilterCost(self):
+        """Verify AUTO reports the engine it selected and that it is no more costly than the FFT filter
+        """
+        fs = 100e3
+        sig = genSinWave(fs, 12.7e3, 64*1024)
+        self.setProps(TuneMode="IF", TuningIF=12.5e3, FilterBW=4e3, DesiredOutputRate=5e3)
+
+        self.runEngine(sig, fs, "AUTO", "tfd-stream-auto")
+        autoEngine = self.comp.ActiveFilterEngine
+        autoCost = self.comp.FilterCost
+        self.assertTrue(autoEngine in ("FFT", "FUSED", "BANDPASS", "MULTISTAGE"))
+        self.assertTrue(autoCost > 0)
+
+        self.runEngine(sig, fs, "FFT", "tfd-stream-fft")
+        self.assertEqual(self.comp.ActiveFilterEngine, "FFT")
+        self.assertTrue(self.comp.FilterCost > 0)
+        if autoEngine in ("FFT", "FUSED"):
+            # same design, so the choice is between exactly these two estimates
+            # (BANDPASS is weighed against them with the mixer they need on top)
+            self.assertTrue(autoCost <= self.comp.FilterCost)
+
+    def testTelemetry(self):
+        """Verify the telemetry struct counts packets and samples and times the stages only when enabled
+        """
+        fs = 100e3
+        sig = genSinWave(fs, 12.7e3, 64*1024)
+        self.setProps(TuneMode="IF", TuningIF=12.5e3, FilterBW=4e3, DesiredOutputRate=5e3)
+
+        self.main(sig, fs, checkOutputSize=False, pktSize=4096, streamID="tfd-stream-off")
+        telemetry = props_to_dict(self.comp.query([]))['telemetry']
+        self.assertEqual(telemetry['telemetry::Packets'], 0)
+        self.src.reset()
+        self.sink.reset()
+
+        self.comp.TelemetryEnabled = True
+        self.main(sig, fs, checkOutputSize=False, pktSize=4096, streamID="tfd-stream-on")
+        telemetry = props_to_dict(self.comp.query([]))['telemetry']
+        self.assertEqual(telemetry['telemetry::Packets'], len(sig)/2/4096)
+        self.assertEqual(telemetry['telemetry::Samples'], len(sig)/2)
+        self.assertEqual(telemetry['telemetry::DroppedPackets'], 0)
+        self.assertTrue(telemetry['telemetry::Rebuilds'] >= 1)
+        self.assertTrue(telemetry['telemetry::FilterTime'] > 0)
+        self.assertTrue(telemetry['telemetry::PushTime'] > 0)
+
+    def testAutoFFTSize(self):
+        """Verify AutoFFTSize reports a 2^a*3^b*5^c FFT size and that the filter output matches a fixed size
+        """
+        fs = 100e3
+        sig = genSinWave(fs, 12.7e3, 256*1024)
+        self.setProps(TuneMode="IF", TuningIF=12.5e3, FilterBW=4e3, DesiredOutputRate=5e3, filterProps=[4096,800,0.01])
+
+        outPoly = self.runEngine(sig, fs, "POLYPHASE", "tfd-stream-poly")
+        self.comp.AutoFFTSize = True
+        outAuto = self.runEngine(sig, fs, "FFT", "tfd-stream-auto", checkOutputSize=True)
+        fftSize = self.comp.filterProps.FFT_size
+        self.assertTrue(fftSize > self.comp.taps)
+        for p in (2, 3, 5):
+            while fftSize % p == 0:
+                fftSize /= p
+        self.assertEqual(fftSize, 1)
+
+        # same filter, so the outputs agree as far as the FFT filter's last complete block
+        self.assertTrue(len(outAuto) <= len(outPoly))
+        self.assertOutputsAgree(outAuto, outPoly)
+
+    def testRationalResampling(self):
+        """Resample 25 kHz to exactly 2 kHz by 2/25 and verify the rate, the output length and the tone frequency
+        """
+        fs = 25e3
+        sig = genSinWave(fs, 5e3+200, 250*1024)
+        self.setProps(TuneMode="IF", TuningIF=5e3, FilterBW=1.5e3, DesiredOutputRate=2e3, filterProps=[128,100,0.01])
+
+        self.comp.RationalResampling = True
+        out = self.main(sig, fs, checkOutputSize=False)
+        self.assertEqual(self.comp.ActiveFilterEngine, "RESAMPLER")
+        self.assertEqual(self.comp.InterpolationFactor, 2)
+        self.assertEqual(self.comp.DecimationFactor, 25)
+        self.assertAlmostEqual(self.comp.ActualOutputRate, 2e3)
+        self.assertAlmostEqual(self.sink.sri().xdelta, 1/2e3)
+        self.assertEqual(len(out), int(math.ceil(len(sig)/2*2/25.0)))
+
+        # past the filter transient, the 200 Hz tone at unity gain
+        tail = out[-1000:]
+        for a in tail:
+            self.assertAlmostEqual(abs(a), 1.0, 1)
+        steps = [cmath.phase(b*a.conjugate()) for a, b in zip(tail[:-1], tail[1:])]
+        self.assertAlmostEqual(sum(steps)/len(steps), 2*math.pi*200/2e3, 3)
+
+    def testResetAfterEOS(self):
+        """Verify a stream ID reused after EOS starts over from an empty filter without the filter being rebuilt
+        """
+        fs = 100e3
+        sig = genSinWave(fs, 12.7e3, 64*1024)
+        self.setProps(TuneMode="IF", TuningIF=12.5e3, FilterBW=4e3, DesiredOutputRate=5e3)
+        self.comp.TelemetryEnabled = True
+
+        outFirst = self.runEngine(sig, fs, "FFT", "tfd-stream-reset")
+        rebuilds = props_to_dict(self.comp.query([]))['telemetry']['telemetry::Rebuilds']
+        outSecond = self.runEngine(sig, fs, None, "tfd-stream-reset")
+        self.assertEqual(props_to_dict(self.comp.query([]))['telemetry']['telemetry::Rebuilds'], rebuilds)
+
+        # same filter history and tuner phase at the start of both streams
+        self.assertEqual(len(outFirst), len(outSecond))
+        self.assertOutputsAgree(outFirst, outSecond, 5)
+
+    def testSRIChangeClasses(self):
+        """Verify keyword-only and RF-only SRI changes are counted by class and do not rebuild the filter
+        """
+        fs = 100e3
+        sig = genSinWave(fs, 12.7e3, 64*1024)
+        self.setProps(TuneMode="IF", TuningIF=12.5e3, FilterBW=4e3, DesiredOutputRate=5e3)
+        self.comp.TelemetryEnabled = True
+
+        pktSize = 8192
+        numPushes = len(sig)/pktSize
+        def keywords(i, numPushes):
+            colRF = 100e6 if i < numPushes-1 else 101e6
+            return {'SRIKeywords': [sb.io_helpers.SRIKeyword('COL_RF', colRF, 'double'),
+                                    sb.io_helpers.SRIKeyword('PKT_NUM', min(i, numPushes-2), 'long')]}
+        out = self.pushAndDrain(sig, fs, "tfd-stream-sri", pktSize=pktSize, eachPacket=keywords)
+
+        telemetry = props_to_dict(self.comp.query([]))['telemetry']
+        self.assertEqual(telemetry['telemetry::SRIKeywordChanges'], numPushes-2)
+        self.assertEqual(telemetry['telemetry::SRIRFChanges'], 1)
+        self.assertEqual(telemetry['telemetry::SRIModeChanges'], 0)
+        self.assertEqual(telemetry['telemetry::SRIRateChanges'], 0)
+        self.assertEqual(telemetry['telemetry::Rebuilds'], 1)
+        self.assertTrue(len(out) > 0)
+
+    def testPartitionedEngine(self):
+        """Verify the partitioned engine matches the polyphase engine with its latency capped by PartitionSize
+        """
+        fs = 100e3
+        sig = [random.random()-.5 for _ in xrange(2*256*1024)]
+        self.setProps(TuneMode="IF", TuningIF=12.5e3, FilterBW=4e3, DesiredOutputRate=5e3, filterProps=[65536,200,0.01])
+
+        outPoly = self.runEngine(sig, fs, "POLYPHASE", "tfd-stream-poly")
+        self.assertEqual(self.comp.FilterLatency, 0)
+        self.comp.PartitionSize = 512
+        outPart = self.runEngine(sig, fs, "PARTITIONED", "tfd-stream-part")
+        self.assertEqual(self.comp.ActiveFilterEngine, "PARTITIONED")
+        self.assertTrue(self.comp.taps > 512)
+        self.assertEqual(self.comp.FilterLatency, 512)
+        self.assertAlmostEqual(self.comp.FilterLatencyTime, 512/fs)
+        self.assertEqual(self.comp.filterProps.FFT_size, 65536)
+
+        # everything but the samples of the last incomplete block
+        self.assertTrue(len(outPart) >= len(outPoly) - 512/20)
+        self.assertOutputsAgree(outPart, outPoly)
+
+    def testBandpassEngine(self):
+        """Verify filtering and decimating before tuning matches tuning first, for complex and real input
+        """
+        fs = 100e3
+        sig = [random.random()-.5 for _ in xrange(2*256*1024)]
+        self.setProps(TuneMode="IF", TuningIF=12.5e3, FilterBW=4e3, DesiredOutputRate=5e3)
+
+        for complexData in (True, False):
+            outPoly = self.runEngine(sig, fs, "POLYPHASE", "tfd-stream-poly", complexData=complexData)
+            outBand = self.runEngine(sig, fs, "BANDPASS", "tfd-stream-band", complexData=complexData)
+            self.assertEqual(self.comp.ActiveFilterEngine, "BANDPASS")
+
+            self.assertEqual(len(outPoly), len(outBand))
+            self.assertOutputsAgree(outPoly, outBand)
+
+    def testChannels(self):
+        """Extract channels with the shared FFT channelizer and compare them to the single channel output
+        """
+        fs = 100e3
+        sig = [random.random()-.5 for _ in xrange(2*256*1024)]
+        self.comp.TuneMode = "IF"
+        self.comp.TuningIF = 12.5e3
+        self.comp.FilterBW = 4e3
+        self.comp.DesiredOutputRate = 5e3
+
+        outSingle = self.runEngine(sig, fs, "POLYPHASE", "tfd-stream-single")
+
+        self.comp.channels = [{'channel::TuningIF':12.5e3, 'channel::FilterBW':4e3, 'channel::DesiredOutputRate':5e3}]
+        outChan = self.runEngine(sig, fs, None, "tfd-stream-chan")
+        self.assertEqual(self.sink.sri().streamID, "tfd-stream-chan_ch0")
+        self.assertAlmostEqual(self.sink.sri().xdelta, 1/5e3)
+        # the channelizer only outputs complete FFT blocks, so it may lag behind by up to one block
+        self.assertTrue(len(outChan) > 0)
+        self.assertTrue(len(outChan) <= len(outSingle))
+        self.assertOutputsAgree(outSingle, outChan)
+
+        self.comp.channels = [{'channel::TuningIF':12.5e3, 'channel::FilterBW':4e3, 'channel::DesiredOutputRate':5e3},
+                              {'channel::TuningIF':-20e3, 'channel::FilterBW':4e3, 'channel::DesiredOutputRate':5e3}]
+        out = self.runEngine(sig, fs, None, "tfd-stream-chan2")
+        # both channels have the same filter length and decimation, so each produces as many samples as one channel alone
+        self.assertEqual(len(out), 2*len(outChan))
+
     def checkKeywords(self,inData, sampleRate, colRF=0.0, complexData = True, colRfType='double', pktSize=8192, checkOutputSize=True, streamID="tfd-stream-1", expectedChanRf=0.0):
         """ Check Keywords CHAN_RF and COL_RF
            As applicable
@@ -841,6 +1428,9 @@ class ComponentTests(ossie.utils.testing.ScaComponentTestCase):
         outputRate = 1.0/ sri.xdelta
         expectedDecimation = math.floor(sampleRate/self.comp.DesiredOutputRate)
         expectedOutputRate = sampleRate/expectedDecimation
+        if self.comp.RationalResampling:
+            expectedDecimation = self.comp.DecimationFactor/float(self.comp.InterpolationFactor)
+            expectedOutputRate = sampleRate/expectedDecimation
         self.assertAlmostEqual(expectedOutputRate,outputRate, places=2)
         self.assertAlmostEqual(self.comp.ActualOutputRate,outputRate, places=2)
         